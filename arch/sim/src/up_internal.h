@@ -327,13 +327,17 @@ FAR struct ioexpander_dev_s *sim_ioexpander_initialize(void);
 #if defined(CONFIG_NET_ETHERNET) && !defined(__CYGWIN__)
 void tapdev_init(void);
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen);
+unsigned int tapdev_tryread(unsigned char *buf, unsigned int buflen);
 void tapdev_send(unsigned char *buf, unsigned int buflen);
+void tapdev_sendv(unsigned char **bufs, unsigned int *lens, int nbufs);
 void tapdev_ifup(in_addr_t ifaddr);
 void tapdev_ifdown(void);
 
 #  define netdev_init()           tapdev_init()
 #  define netdev_read(buf,buflen) tapdev_read(buf,buflen)
+#  define netdev_tryread(buf,buflen) tapdev_tryread(buf,buflen)
 #  define netdev_send(buf,buflen) tapdev_send(buf,buflen)
+#  define netdev_sendv(bufs,lens,nbufs) tapdev_sendv(bufs,lens,nbufs)
 #  define netdev_ifup(ifaddr)     tapdev_ifup(ifaddr)
 #  define netdev_ifdown()         tapdev_ifdown()
 #endif
@@ -347,6 +351,7 @@ void wpcap_send(unsigned char *buf, unsigned int buflen);
 
 #  define netdev_init()           wpcap_init()
 #  define netdev_read(buf,buflen) wpcap_read(buf,buflen)
+#  define netdev_tryread(buf,buflen) wpcap_read(buf,buflen)
 #  define netdev_send(buf,buflen) wpcap_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     {}
 #  define netdev_ifdown()         {}
@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <errno.h>
 #include <sched.h>
 #include <nuttx/net/net.h>
 
@@ -60,6 +61,10 @@
 #  include <nuttx/net/pkt.h>
 #endif
 
+#ifdef CONFIG_NETDEV_IOB
+#  include <nuttx/net/iob.h>
+#endif
+
 #include "up_internal.h"
 
 /****************************************************************************
@@ -68,6 +73,17 @@
 
 #define BUF ((struct eth_hdr_s *)g_sim_dev.d_buf)
 
+/* With the I/O buffer packet interface, outgoing frames are queued and
+ * sent at the end of each pass if the host can gather a frame from
+ * several buffers.  SIM_NIOV is the most buffers that one frame can use.
+ */
+
+#if defined(CONFIG_NETDEV_IOB) && defined(netdev_sendv)
+#  define SIM_TXQUEUE 1
+#  define SIM_NIOV \
+     ((CONFIG_NET_ETH_MTU + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -92,6 +108,25 @@ static uint8_t g_pktbuf[MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE];
 
 static struct net_driver_s g_sim_dev;
 
+#ifdef CONFIG_NETDEV_IOB
+/* Frames received from the host, waiting to be passed to the network */
+
+static struct iob_queue_s g_rxq;
+
+/* A frame that was read from the host but could not be copied into I/O
+ * buffers.  It is passed to the network from d_buf after the batch.
+ */
+
+static uint8_t g_rxbuf[MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE];
+static unsigned int g_rxpending;
+
+#ifdef SIM_TXQUEUE
+/* Frames waiting to be sent to the host */
+
+static struct iob_queue_s g_txq;
+#endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -121,6 +156,64 @@ static inline int up_comparemac(uint8_t *paddr1, struct ether_addr *paddr2)
 }
 #endif
 
+#ifdef SIM_TXQUEUE
+static void sim_txflush(void)
+{
+  FAR unsigned char *bufs[SIM_NIOV];
+  unsigned int lens[SIM_NIOV];
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  int nbufs;
+
+  /* Gather each frame from its I/O buffers and send it to the host */
+
+  while ((iob = iob_remove_queue(&g_txq)) != NULL)
+    {
+      for (next = iob, nbufs = 0;
+           next != NULL && nbufs < SIM_NIOV;
+           next = next->io_flink, nbufs++)
+        {
+          bufs[nbufs] = IOB_DATA(next);
+          lens[nbufs] = next->io_len;
+        }
+
+      DEBUGASSERT(next == NULL);
+      netdev_sendv(bufs, lens, nbufs);
+      iob_free_chain(iob);
+    }
+}
+#else
+#  define sim_txflush()
+#endif
+
+static void sim_transmit(void)
+{
+#ifdef SIM_TXQUEUE
+  FAR struct iob_s *iob;
+
+  /* Queue a copy of the frame to be sent at the end of this pass */
+
+  iob = netdev_iob_output(&g_sim_dev);
+  if (iob != NULL)
+    {
+      if (iob_tryadd_queue(iob, &g_txq) >= 0)
+        {
+          return;
+        }
+
+      iob_free_chain(iob);
+    }
+
+  /* Out of I/O buffers:  Send the queued frames and then this one so that
+   * the frames leave in order.
+   */
+
+  sim_txflush();
+#endif
+
+  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
+}
+
 static int sim_txpoll(struct net_driver_s *dev)
 {
   /* If the polling resulted in data that should be sent out on the network,
@@ -153,7 +246,7 @@ static int sim_txpoll(struct net_driver_s *dev)
 
       /* Send the packet */
 
-      netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
+      sim_transmit();
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -163,154 +256,247 @@ static int sim_txpoll(struct net_driver_s *dev)
   return 0;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-void netdriver_loop(void)
+static void sim_rxframe(FAR struct net_driver_s *dev)
 {
   FAR struct eth_hdr_s *eth;
 
-  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
-
-  g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
-                                CONFIG_NET_ETH_MTU);
-
-  /* Disable preemption through to the following so that it behaves a little more
-   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
-   * oddly.
-   */
+  /* Check for valid Ethernet header with destination == our MAC address */
 
-  sched_lock();
-  if (g_sim_dev.d_len > 0)
+  eth = BUF;
+  if (g_sim_dev.d_len > ETH_HDRLEN)
     {
-      /* Data received event.  Check for valid Ethernet header with destination == our
-       * MAC address
-       */
-
-      eth = BUF;
-      if (g_sim_dev.d_len > ETH_HDRLEN)
-        {
-         int is_ours;
+      int is_ours;
 
-         /* Figure out if this ethernet frame is addressed to us.  This affects
-           * what we're willing to receive.   Note that in promiscuous mode, the
-           * up_comparemac will always return 0.
-           */
+      /* Figure out if this ethernet frame is addressed to us.  This affects
+       * what we're willing to receive.   Note that in promiscuous mode, the
+       * up_comparemac will always return 0.
+       */
 
-         is_ours = (up_comparemac(eth->dest, &g_sim_dev.d_mac) == 0);
+      is_ours = (up_comparemac(eth->dest, &g_sim_dev.d_mac) == 0);
 
 #ifdef CONFIG_NET_PKT
-          /* When packet sockets are enabled, feed the frame into the packet
-           * tap.
-           */
+      /* When packet sockets are enabled, feed the frame into the packet
+       * tap.
+       */
 
-          if (is_ours)
-            {
-              pkt_input(&g_sim_dev);
-            }
+      if (is_ours)
+        {
+          pkt_input(&g_sim_dev);
+        }
 #endif
 
-          /* We only accept IP packets of the configured type and ARP packets */
+      /* We only accept IP packets of the configured type and ARP packets */
 
 #ifdef CONFIG_NET_IPv4
-          if (eth->type == HTONS(ETHTYPE_IP) && is_ours)
-            {
-              ninfo("IPv4 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP) && is_ours)
+        {
+          ninfo("IPv4 frame\n");
 
-              /* Handle ARP on input then give the IPv4 packet to the network
-               * layer
-               */
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer
+           */
 
-              arp_ipin(&g_sim_dev);
-              ipv4_input(&g_sim_dev);
+          arp_ipin(&g_sim_dev);
+          ipv4_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+            {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv6
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
 #endif
-                    {
-                      arp_out(&g_sim_dev);
-                    }
+                {
+                  arp_out(&g_sim_dev);
+                }
 #ifdef CONFIG_NET_IPv6
-                  else
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+              else
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              sim_transmit();
             }
-          else
+        }
+      else
 #endif
 #ifdef CONFIG_NET_IPv6
-          if (eth->type == HTONS(ETHTYPE_IP6) && is_ours)
-            {
-              ninfo("Iv6 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP6) && is_ours)
+        {
+          ninfo("Iv6 frame\n");
 
-              /* Give the IPv6 packet to the network layer */
+          /* Give the IPv6 packet to the network layer */
 
-              ipv6_input(&g_sim_dev);
+          ipv6_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-               {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+            {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv4
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
-                    {
-                      arp_out(&g_sim_dev);
-                    }
-                  else
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
+                {
+                  arp_out(&g_sim_dev);
+                }
+              else
 #endif
 #ifdef CONFIG_NET_IPv6
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              sim_transmit();
             }
-          else
+        }
+      else
 #endif
 #ifdef CONFIG_NET_ARP
-          if (eth->type == htons(ETHTYPE_ARP))
-            {
-              arp_arpin(&g_sim_dev);
+      if (eth->type == htons(ETHTYPE_ARP))
+        {
+          arp_arpin(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+          if (g_sim_dev.d_len > 0)
+            {
+              sim_transmit();
             }
+        }
 #endif
+    }
+}
+
+#ifdef CONFIG_NETDEV_IOB
+static int sim_rxbatch(void)
+{
+  FAR struct iob_s *iob;
+  unsigned int len;
+  int nframes;
+
+  for (nframes = 0; nframes < CONFIG_SIM_NET_RXBATCH; nframes++)
+    {
+      /* Leave any further frames with the host if there is no free I/O
+       * buffer to hold the next one.
+       */
+
+      iob = iob_tryalloc(true);
+      if (iob == NULL)
+        {
+          return nframes > 0 ? nframes : -ENOMEM;
+        }
+
+      /* Only the first read waits for a frame to arrive */
+
+      if (nframes == 0)
+        {
+          len = netdev_read(g_pktbuf, CONFIG_NET_ETH_MTU);
+        }
+      else
+        {
+          len = netdev_tryread(g_pktbuf, CONFIG_NET_ETH_MTU);
+        }
+
+      if (len == 0)
+        {
+          iob_free_chain(iob);
+          break;
+        }
+
+      if (iob_trycopyin(iob, g_pktbuf, len, 0, true) < 0 ||
+          iob_tryadd_queue(iob, &g_rxq) < 0)
+        {
+          /* The frame has already been taken from the host.  Keep it so
+           * that it can be received through d_buf after the batch.
+           */
+
+          iob_free_chain(iob);
+          memcpy(g_rxbuf, g_pktbuf, len);
+          g_rxpending = len;
+          break;
         }
     }
 
+  return nframes;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void netdriver_loop(void)
+{
+#ifdef CONFIG_NETDEV_IOB
+  int nframes;
+
+  /* Read a batch of frames into I/O buffer chains.  If no I/O buffer is
+   * free, fall through and receive a single frame in d_buf.
+   */
+
+  nframes = sim_rxbatch();
+  if (nframes >= 0)
+    {
+      sched_lock();
+      if (nframes > 0)
+        {
+          (void)netdev_iob_input(&g_sim_dev, &g_rxq, sim_rxframe);
+        }
+
+      if (g_rxpending > 0)
+        {
+          memcpy(g_sim_dev.d_buf, g_rxbuf, g_rxpending);
+          g_sim_dev.d_len = g_rxpending;
+          g_rxpending     = 0;
+
+          sim_rxframe(&g_sim_dev);
+        }
+      else if (nframes == 0 && timer_expired(&g_periodic_timer))
+        {
+          timer_reset(&g_periodic_timer);
+          devif_timer(&g_sim_dev, sim_txpoll);
+        }
+
+      sim_txflush();
+      sched_unlock();
+      return;
+    }
+#endif
+
+  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
+
+  g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
+                                CONFIG_NET_ETH_MTU);
+
+  /* Disable preemption through to the following so that it behaves a little more
+   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
+   * oddly.
+   */
+
+  sched_lock();
+  if (g_sim_dev.d_len > 0)
+    {
+      sim_rxframe(&g_sim_dev);
+    }
+
   /* Otherwise, it must be a timeout event */
 
   else if (timer_expired(&g_periodic_timer))
@@ -319,6 +505,7 @@ void netdriver_loop(void)
       devif_timer(&g_sim_dev, sim_txpoll);
     }
 
+  sim_txflush();
   sched_unlock();
 }
 
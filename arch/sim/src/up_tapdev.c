@@ -52,6 +52,7 @@
 #include <sys/socket.h>
 
 #include <fcntl.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -76,6 +77,12 @@
 
 #define DEVTAP        "/dev/net/tun"
 
+/* The maximum number of buffers that tapdev_sendv() may gather into one
+ * frame.
+ */
+
+#define TAPDEV_MAXIOV 64
+
 /* Syslog priority (must match definitions in nuttx/include/syslog.h) */
 
 #define LOG_INFO      1  /* Informational message */
@@ -170,6 +177,45 @@ static int up_setmacaddr(void)
   return ret;
 }
 
+static unsigned int tapdev_recv(unsigned char *buf, unsigned int buflen,
+                                long usec)
+{
+  fd_set                fdset;
+  struct timeval        tv;
+  int                   ret;
+
+  /* We can't do anything if we failed to open the tap device */
+
+  if (gtapdevfd < 0)
+    {
+      return 0;
+    }
+
+  /* Wait up to usec microseconds for data on the tap device */
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = usec;
+
+  FD_ZERO(&fdset);
+  FD_SET(gtapdevfd, &fdset);
+
+  ret = select(gtapdevfd + 1, &fdset, NULL, NULL, &tv);
+  if (ret == 0)
+    {
+      return 0;
+    }
+
+  ret = read(gtapdevfd, buf, buflen);
+  if (ret < 0)
+    {
+      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
+      return 0;
+    }
+
+  dump_ethhdr("read", buf, ret);
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -242,40 +288,12 @@ void tapdev_init(void)
 
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
 {
-  fd_set                fdset;
-  struct timeval        tv;
-  int                   ret;
-
-  /* We can't do anything if we failed to open the tap device */
-
-  if (gtapdevfd < 0)
-    {
-      return 0;
-    }
-
-  /* Wait for data on the tap device (or a timeout) */
-
-  tv.tv_sec  = 0;
-  tv.tv_usec = 1000;
-
-  FD_ZERO(&fdset);
-  FD_SET(gtapdevfd, &fdset);
-
-  ret = select(gtapdevfd + 1, &fdset, NULL, NULL, &tv);
-  if (ret == 0)
-    {
-      return 0;
-    }
-
-  ret = read(gtapdevfd, buf, buflen);
-  if (ret < 0)
-    {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
-      return 0;
-    }
+  return tapdev_recv(buf, buflen, 1000);
+}
 
-  dump_ethhdr("read", buf, ret);
-  return ret;
+unsigned int tapdev_tryread(unsigned char *buf, unsigned int buflen)
+{
+  return tapdev_recv(buf, buflen, 0);
 }
 
 void tapdev_send(unsigned char *buf, unsigned int buflen)
@@ -302,6 +320,40 @@ void tapdev_send(unsigned char *buf, unsigned int buflen)
   dump_ethhdr("write", buf, buflen);
 }
 
+void tapdev_sendv(unsigned char **bufs, unsigned int *lens, int nbufs)
+{
+  struct iovec iov[TAPDEV_MAXIOV];
+  unsigned int buflen = 0;
+  int ret;
+  int i;
+
+  if (nbufs > TAPDEV_MAXIOV)
+    {
+      syslog(LOG_ERR, "TAPDEV: too many buffers: %d\n", nbufs);
+      return;
+    }
+
+  for (i = 0; i < nbufs; i++)
+    {
+      iov[i].iov_base = bufs[i];
+      iov[i].iov_len  = lens[i];
+      buflen         += lens[i];
+    }
+
+  ret = writev(gtapdevfd, iov, nbufs);
+  if (ret < 0)
+    {
+      /* The host may be briefly unable to take the frame.  Drop it and let
+       * the network recover as it would from a lost frame on the wire.
+       */
+
+      syslog(LOG_ERR, "TAPDEV: writev failed: %d\n", errno);
+      return;
+    }
+
+  dump_ethhdr("writev", bufs[0], buflen);
+}
+
 void tapdev_ifup(in_addr_t ifaddr)
 {
   struct ifreq ifr;
@@ -52,6 +52,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_BCH_NSECTORS
+#  define CONFIG_BCH_NSECTORS 1
+#endif
+
 #define bchlib_semgive(d) sem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
@@ -70,7 +74,15 @@ struct bchlib_s
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* The current sector buffer */
+
+#if CONFIG_BCH_NSECTORS > 1
+  FAR uint8_t *cache;      /* Allocated buffers for all cached sectors */
+  uint8_t cindex;          /* Index of the current sector buffer */
+  uint32_t cclock;         /* Incremented on each access (for LRU) */
+  size_t csector[CONFIG_BCH_NSECTORS];  /* Sector in each buffer */
+  uint32_t cstamp[CONFIG_BCH_NSECTORS]; /* Time of the last access */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -98,6 +110,8 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -103,6 +103,67 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+/****************************************************************************
+ * Name: bchlib_cacheselect
+ *
+ * Description:
+ *   Make the cache buffer at 'index' the current sector buffer and mark it
+ *   as the most recently used.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BCH_NSECTORS > 1
+static void bchlib_cacheselect(FAR struct bchlib_s *bch, int index)
+{
+  bch->cindex        = index;
+  bch->buffer        = &bch->cache[index * bch->sectsize];
+  bch->cstamp[index] = ++bch->cclock;
+}
+#endif
+
+/****************************************************************************
+ * Name: bchlib_cachelookup
+ *
+ * Description:
+ *   Search the cache for 'sector'.  If it is found, make it the current
+ *   sector buffer and return true.  Otherwise, select the buffer to be
+ *   replaced (an unused buffer or the least recently used one), make it the
+ *   current sector buffer, and return false.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BCH_NSECTORS > 1
+static bool bchlib_cachelookup(FAR struct bchlib_s *bch, size_t sector)
+{
+  int victim = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      if (bch->csector[i] == sector)
+        {
+          bchlib_cacheselect(bch, i);
+          return true;
+        }
+
+      /* Prefer an unused buffer, then the oldest one.  Unsigned
+       * subtraction handles wrap-around of the access clock.
+       */
+
+      if (bch->csector[victim] != (size_t)-1 &&
+          (bch->csector[i] == (size_t)-1 ||
+           bch->cclock - bch->cstamp[i] > bch->cclock - bch->cstamp[victim]))
+        {
+          victim = i;
+        }
+    }
+
+  bch->csector[victim] = (size_t)-1;
+  bchlib_cacheselect(bch, victim);
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -142,7 +203,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
       ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", (int)ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -153,9 +214,14 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
       bch_cypher(bch, CYPHER_DECRYPT);
 #endif
 
-      /* The sector is now in sync with the media */
+      /* The sector is now in sync with the media.  If the write failed,
+       * leave the buffer dirty so that the data is not lost.
+       */
 
-      bch->dirty = false;
+      if (ret >= 0)
+        {
+          bch->dirty = false;
+        }
     }
 
   return (int)ret;
@@ -181,19 +247,79 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
     {
       inode = bch->inode;
 
-      (void)bchlib_flushsector(bch);
+      /* Do not replace the buffer contents if they could not be written */
+
+      ret = bchlib_flushsector(bch);
+      if (ret < 0)
+        {
+          return (int)ret;
+        }
+
       bch->sector = (size_t)-1;
 
+#if CONFIG_BCH_NSECTORS > 1
+      /* Check if the sector is still in the cache */
+
+      if (bchlib_cachelookup(bch, sector))
+        {
+          bch->sector = sector;
+          return OK;
+        }
+#endif
+
       ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
       if (ret < 0)
         {
-          ferr("Read failed: %d\n");
+          ferr("Read failed: %d\n", (int)ret);
+          return (int)ret;
         }
+
+#if CONFIG_BCH_NSECTORS > 1
+      bch->csector[bch->cindex] = sector;
+#endif
+
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
       bch_cypher(bch, CYPHER_DECRYPT);
 #endif
     }
+
   return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Discard any cached copies of the sectors in the range
+ *   [sector, sector + nsectors).  This must be called when those sectors
+ *   are written to the media directly, bypassing the sector buffer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+#if CONFIG_BCH_NSECTORS > 1
+  int i;
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      if (bch->csector[i] >= sector && bch->csector[i] - sector < nsectors)
+        {
+          bch->csector[i] = (size_t)-1;
+        }
+    }
+#endif
+
+  /* The direct write supersedes any modifications in the current buffer */
+
+  if (bch->sector >= sector && bch->sector - sector < nsectors)
+    {
+      bch->sector = (size_t)-1;
+      bch->dirty  = false;
+    }
+}
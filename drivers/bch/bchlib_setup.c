@@ -71,6 +71,9 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 {
   FAR struct bchlib_s *bch;
   struct geometry geo;
+#if CONFIG_BCH_NSECTORS > 1
+  int i;
+#endif
   int ret;
 
   DEBUGASSERT(blkdev);
@@ -126,6 +129,22 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 
   /* Allocate the sector I/O buffer */
 
+#if CONFIG_BCH_NSECTORS > 1
+  bch->cache = (FAR uint8_t *)kmm_malloc(bch->sectsize * CONFIG_BCH_NSECTORS);
+  if (!bch->cache)
+    {
+      ferr("ERROR: Failed to allocate sector cache\n");
+      ret = -ENOMEM;
+      goto errout_with_bch;
+    }
+
+  for (i = 0; i < CONFIG_BCH_NSECTORS; i++)
+    {
+      bch->csector[i] = (size_t)-1;
+    }
+
+  bch->buffer = bch->cache;
+#else
   bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
   if (!bch->buffer)
     {
@@ -133,6 +152,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       ret = -ENOMEM;
       goto errout_with_bch;
     }
+#endif
 
   *handle = bch;
   return OK;
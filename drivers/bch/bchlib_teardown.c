@@ -85,10 +85,17 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
+#if CONFIG_BCH_NSECTORS > 1
+  if (bch->cache)
+    {
+      kmm_free(bch->cache);
+    }
+#else
   if (bch->buffer)
     {
       kmm_free(bch->buffer);
     }
+#endif
 
   sem_destroy(&bch->sem);
   kmm_free(bch);
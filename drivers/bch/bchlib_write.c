@@ -99,7 +99,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     {
       /* Read the full sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -151,6 +155,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           return ret;
         }
 
+      /* Any cached copies of these sectors are now stale */
+
+      bchlib_invalidate(bch, sector, nsectors);
+
       /* Adjust pointers and counts */
 
       sector       += nsectors;
@@ -172,7 +180,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
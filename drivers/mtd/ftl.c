@@ -63,6 +63,10 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#if defined(CONFIG_FTL_PROGRAM_ERASED) && !defined(CONFIG_FTL_ERASEDSTATE)
+#  define CONFIG_FTL_ERASEDSTATE 0xff
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -199,6 +203,104 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #endif
 }
 
+/****************************************************************************
+ * Name: ftl_update
+ *
+ * Description: Write nblocks R/W blocks at offset within the erase block
+ *   that begins at rwblock.  The erase block is read into dev->eblock
+ *   first.  Nothing is written if the data is unchanged.  With
+ *   CONFIG_FTL_PROGRAM_ERASED, the erase is also skipped if the blocks being
+ *   written are still in the erased state.  Only otherwise is the whole
+ *   erase block erased and rewritten.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_update(FAR struct ftl_struct_s *dev, off_t rwblock,
+                      off_t offset, size_t nblocks,
+                      FAR const uint8_t *buffer)
+{
+  FAR uint8_t *dest;
+  off_t  eraseblock;
+  size_t nbytes;
+  size_t nxfrd;
+#ifdef CONFIG_FTL_PROGRAM_ERASED
+  size_t i;
+#endif
+  int    ret;
+
+  /* Read the full erase block into the buffer */
+
+  nxfrd = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  dest   = dev->eblock + offset * dev->geo.blocksize;
+  nbytes = nblocks * dev->geo.blocksize;
+
+  /* Is the data already on the FLASH? */
+
+  if (memcmp(dest, buffer, nbytes) == 0)
+    {
+      finfo("Erase block %d unchanged\n", rwblock / dev->blkper);
+      return OK;
+    }
+
+#ifdef CONFIG_FTL_PROGRAM_ERASED
+  /* If the blocks to be written are still erased, then just program them.
+   * This is only safe on NOR FLASH.
+   */
+
+  for (i = 0; i < nbytes && dest[i] == CONFIG_FTL_ERASEDSTATE; i++);
+
+  if (i >= nbytes)
+    {
+      finfo("Program %d blocks at block=%d\n", nblocks, rwblock + offset);
+
+      nxfrd = MTD_BWRITE(dev->mtd, rwblock + offset, nblocks, buffer);
+      if (nxfrd != nblocks)
+        {
+          ferr("ERROR: Write block %d failed: %d\n", rwblock + offset, nxfrd);
+          return -EIO;
+        }
+
+      return OK;
+    }
+#endif
+
+  /* Otherwise erase the erase block */
+
+  eraseblock = rwblock / dev->blkper;
+  ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
+      return ret;
+    }
+
+  /* Copy the user data into the buffered erase block */
+
+  finfo("Copy %d bytes into erase block=%d at offset=%d\n",
+         nbytes, eraseblock, offset * dev->geo.blocksize);
+
+  memcpy(dest, buffer, nbytes);
+
+  /* And write the erase block back to flash */
+
+  nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_flush
  *
@@ -213,12 +315,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   off_t  alignedblock;
   off_t  mask;
-  off_t  rwblock;
   off_t  eraseblock;
-  off_t  offset;
   size_t remaining;
   size_t nxfrd;
-  int    nbytes;
+  size_t nblks;
   int    ret;
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
@@ -236,67 +336,23 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
     {
       /* Check if the write is shorter than to the end of the erase block */
 
-      bool short_write = (remaining < (alignedblock - startblock));
-
-      /* Read the full erase block into the buffer */
-
-      rwblock = startblock & ~mask;
-      nxfrd   = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
+      nblks = alignedblock - startblock;
+      if (remaining < nblks)
         {
-          ferr("ERROR: Read erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
+          nblks = remaining;
         }
 
-      /* Then erase the erase block */
-
-      eraseblock = rwblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+      ret = ftl_update(dev, startblock & ~mask, startblock & mask, nblks,
+                       buffer);
       if (ret < 0)
         {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
           return ret;
         }
 
-      /* Copy the user data at the end of the buffered erase block */
-
-      offset = (startblock & mask) * dev->geo.blocksize;
-
-      if (short_write)
-        {
-          nbytes = remaining * dev->geo.blocksize;
-        }
-      else
-        {
-          nbytes = dev->geo.erasesize - offset;
-        }
-
-      finfo("Copy %d bytes into erase block=%d at offset=%d\n",
-             nbytes, eraseblock, offset);
-
-      memcpy(dev->eblock + offset, buffer, nbytes);
-
-      /* And write the erase block back to flash */
-
-      nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
-        }
-
       /* Then update for amount written */
 
-      if (short_write)
-        {
-          remaining = 0;
-        }
-      else
-        {
-          remaining -= dev->blkper - (startblock & mask);
-        }
-
-      buffer += nbytes;
+      remaining -= nblks;
+      buffer    += nblks * dev->geo.blocksize;
     }
 
   /* How handle full erase pages in the middle */
@@ -336,40 +392,11 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
   if (remaining > 0)
     {
-      /* Read the full erase block into the buffer */
-
-     nxfrd = MTD_BREAD(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Read erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
-
-      /* Then erase the erase block */
-
-      eraseblock = alignedblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+      ret = ftl_update(dev, alignedblock, 0, remaining, buffer);
       if (ret < 0)
         {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
           return ret;
         }
-
-      /* Copy the user data at the beginning the buffered erase block */
-
-      nbytes = remaining * dev->geo.blocksize;
-      finfo("Copy %d bytes into erase block=%d at offset=0\n",
-             nbytes, alignedblock);
-      memcpy(dev->eblock, buffer, nbytes);
-
-      /* And write the erase back to flash */
-
-      nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
     }
 
   return nblocks;
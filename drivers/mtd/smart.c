@@ -51,6 +51,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <semaphore.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -58,6 +59,8 @@
 #include <crc16.h>
 #include <crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -130,6 +133,28 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+/* Garbage collection.  Background collection requires the low priority
+ * work queue and is meaningless on a read-only file system.
+ */
+
+#ifndef CONFIG_MTD_SMART_GC_MAXBLOCKS
+#  define CONFIG_MTD_SMART_GC_MAXBLOCKS 0
+#endif
+
+#if !defined(CONFIG_SCHED_LPWORK) || !defined(CONFIG_FS_WRITABLE)
+#  undef CONFIG_MTD_SMART_GC_WORKER
+#endif
+
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+#  ifndef CONFIG_MTD_SMART_GC_HIGHWATER
+#    define CONFIG_MTD_SMART_GC_HIGHWATER 25
+#  endif
+#  ifndef CONFIG_MTD_SMART_GC_DELAY
+#    define CONFIG_MTD_SMART_GC_DELAY 100
+#  endif
+#  define SMART_GC_DELAY  MSEC2TICK(CONFIG_MTD_SMART_GC_DELAY)
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -221,6 +246,13 @@ struct smart_struct_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   uint32_t              unusedsectors;    /* Count of unused sectors (i.e. free when erased) */
   uint32_t              blockerases;      /* Count of unused sectors (i.e. free when erased) */
+  uint32_t              gcblocks;         /* Erase blocks collected in the write path */
+  uint32_t              gcbgblocks;       /* Erase blocks collected in the background */
+  uint32_t              gcmaxticks;       /* Longest write path collection (ticks) */
+#endif
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+  sem_t                 exclsem;          /* Serializes GC worker and driver access */
+  struct work_s         gcwork;           /* Background garbage collection work */
 #endif
   uint16_t              neraseblocks;     /* Number of erase blocks or sub-sectors */
   uint16_t              lastallocblock;   /* Last  block we allocated a sector from */
@@ -381,12 +413,22 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+static int smart_write_wearstatus(FAR struct smart_struct_s *dev);
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+static void smart_lock(FAR struct smart_struct_s *dev);
+static void smart_gc_schedule(FAR struct smart_struct_s *dev);
+#  define smart_unlock(d) sem_post(&(d)->exclsem)
+#else
+#  define smart_lock(d)
+#  define smart_unlock(d)
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -458,6 +500,25 @@ static int smart_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: smart_lock
+ *
+ * Description: Get exclusive access to the device.  Only needed when the
+ *              background garbage collector may relocate sectors
+ *              concurrently with the file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+static void smart_lock(FAR struct smart_struct_s *dev)
+{
+  while (sem_wait(&dev->exclsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_malloc
  *
@@ -801,6 +862,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -810,7 +872,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -847,7 +913,7 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -886,9 +952,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -915,9 +979,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -929,6 +991,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -1047,6 +1110,9 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors = 0;
   dev->blockerases = 0;
+  dev->gcblocks = 0;
+  dev->gcbgblocks = 0;
+  dev->gcmaxticks = 0;
 #endif
 
   /* Release any existing rwbuffer and sMap */
@@ -1444,6 +1510,16 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
   physical = 0xffff;
 
+  /* A logical sector that is not marked as used in the bitmap cannot be on
+   * the media, so there is no need to search for it.
+   */
+
+  if (logical >= dev->totalsectors ||
+      !(dev->sBitMap[logical >> 3] & (1 << (logical & 0x07))))
+    {
+      return physical;
+    }
+
   /* Test if searching for the last sector used */
 
   if (logical == dev->cache_lastlog)
@@ -1483,6 +1559,22 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
           for (block = 0; block < dev->geo.neraseblocks; block++)
             {
+              /* Skip erase blocks that hold no live sectors.  Reading the
+               * headers there would only cost FLASH accesses.
+               */
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+              if (smart_get_count(dev, dev->freecount, block) +
+                  smart_get_count(dev, dev->releasecount, block) >=
+                  dev->availSectPerBlk)
+#else
+              if (dev->freecount[block] + dev->releasecount[block] >=
+                  dev->availSectPerBlk)
+#endif
+                {
+                  continue;
+                }
+
               /* Calculate the read address for this sector */
 
               readaddress = block * dev->erasesize +
@@ -1843,7 +1935,8 @@ static int smart_scan(FAR struct smart_struct_s *dev)
         {
           /* Read the next sector from the device */
 
-          ret = MTD_READ(dev->mtd, 0, sizeof(struct smart_sect_header_s),
+          ret = MTD_READ(dev->mtd, readaddress,
+                         sizeof(struct smart_sect_header_s),
                          (FAR uint8_t *) &header);
           if (ret != sizeof(struct smart_sect_header_s))
             {
@@ -3667,6 +3760,59 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_gc_findblock
+ *
+ * Description:  Find the erase block with the most released sectors.
+ *               Returns 0xffff if no block has released sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint16_t smart_gc_findblock(FAR struct smart_struct_s *dev,
+                                   FAR uint16_t *released)
+{
+  uint16_t  collectblock;
+  uint16_t  releasemax;
+  int       x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  uint8_t   count;
+#endif
+
+  collectblock = 0xffff;
+  releasemax = 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
+        {
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
+        }
+#endif
+    }
+
+  *released = releasemax;
+  return collectblock;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -3674,6 +3820,11 @@ retry:
  *               by the count of released sectors relative to free and
  *               total sectors.
  *
+ *               Collection needed to keep the reserved free sectors is
+ *               always done.  Opportunistic collection is limited to
+ *               CONFIG_MTD_SMART_GC_MAXBLOCKS erase blocks per call (if
+ *               non-zero); the rest is left to the background worker.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
@@ -3681,11 +3832,12 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
   uint16_t  collectblock;
   uint16_t  releasemax;
+  uint16_t  collected = 0;
   bool      collect = TRUE;
-  int       x;
-  int       ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t   count;
+  int       ret = OK;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  systime_t start = clock_systimer();
+  systime_t elapsed;
 #endif
 
   while (collect)
@@ -3699,7 +3851,11 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
       if (dev->releasesectors > dev->freesectors && dev->freesectors <
           (dev->totalsectors >> 5))
         {
+#if CONFIG_MTD_SMART_GC_MAXBLOCKS > 0
+          collect = (collected < CONFIG_MTD_SMART_GC_MAXBLOCKS);
+#else
           collect = TRUE;
+#endif
         }
 
       /* Test if we have more reached our reserved free sector limit */
@@ -3715,43 +3871,13 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-          //releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-
+          collectblock = smart_gc_findblock(dev, &releasemax);
           if (collectblock == 0xffff)
             {
               /* Need to collect, but no sectors with released blocks! */
 
               ret = -ENOSPC;
-              goto errout;
+              break;
             }
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
@@ -3784,18 +3910,140 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
           if (ret != OK)
             {
-              goto errout;
+              break;
             }
+
+          collected++;
         }
     }
 
-  return OK;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  /* Record how long the caller was stalled by the collection */
+
+  if (collected > 0)
+    {
+      elapsed = clock_systimer() - start;
+      if (elapsed > dev->gcmaxticks)
+        {
+          dev->gcmaxticks = elapsed;
+        }
+
+      dev->gcblocks += collected;
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+  /* Let the worker reclaim whatever we did not collect here */
+
+  smart_gc_schedule(dev);
+#endif
 
-errout:
   return ret;
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_gc_bgblock
+ *
+ * Description:  Return the erase block the background worker should
+ *               collect next, or 0xffff if there is nothing worth doing.
+ *               The worker only runs while the free sectors are below the
+ *               high watermark and only collects blocks that are at least
+ *               half released, so that it does not churn the FLASH.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+static uint16_t smart_gc_bgblock(FAR struct smart_struct_s *dev)
+{
+  uint16_t collectblock;
+  uint16_t releasemax;
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      (uint32_t)dev->freesectors * 100 >=
+      (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_GC_HIGHWATER ||
+      dev->releasesectors == 0)
+    {
+      return 0xffff;
+    }
+
+  collectblock = smart_gc_findblock(dev, &releasemax);
+  if (collectblock == 0xffff ||
+      releasemax < ((dev->availSectPerBlk + 1) >> 1))
+    {
+      return 0xffff;
+    }
+
+  return collectblock;
+}
+
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Collect one erase block on the low priority work queue and
+ *               reschedule if there is more to do.
+ *
+ ****************************************************************************/
+
+static void smart_gc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t collectblock;
+  int ret;
+
+  smart_lock(dev);
+
+  collectblock = smart_gc_bgblock(dev);
+  if (collectblock != 0xffff)
+    {
+      finfo("Background collecting block %d\n", collectblock);
+
+      ret = smart_relocate_block(dev, collectblock);
+      if (ret == OK)
+        {
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+          dev->gcbgblocks++;
+#endif
+          smart_gc_schedule(dev);
+        }
+      else
+        {
+          ferr("ERROR: Background collection of block %d failed: %d\n",
+               collectblock, ret);
+        }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+        {
+          /* Write new wear status bits to the device */
+
+          smart_write_wearstatus(dev);
+        }
+#endif
+    }
+
+  smart_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: smart_gc_schedule
+ *
+ * Description:  Queue the background garbage collector if it is not
+ *               already pending and there is work for it.  Called with
+ *               the device locked.
+ *
+ ****************************************************************************/
+
+static void smart_gc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (work_available(&dev->gcwork) && smart_gc_bgblock(dev) != 0xffff)
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev,
+                       SMART_GC_DELAY);
+    }
+}
+#endif /* CONFIG_MTD_SMART_GC_WORKER */
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -3806,7 +4054,7 @@ errout:
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-static int smart_write_wearstatus(struct smart_struct_s *dev)
+static int smart_write_wearstatus(FAR struct smart_struct_s *dev)
 {
   uint16_t  sector;
   uint16_t  remaining, towrite;
@@ -5117,6 +5365,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
    * to directly to the underlying MTD device.
    */
 
+  smart_lock(dev);
   switch (cmd)
     {
     case BIOC_XIPBASE:
@@ -5129,7 +5378,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5217,6 +5467,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       procfs_data->formatversion = dev->formatversion;
       procfs_data->unusedsectors = dev->unusedsectors;
       procfs_data->blockerases = dev->blockerases;
+      procfs_data->gcblocks = dev->gcblocks;
+      procfs_data->gcbgblocks = dev->gcbgblocks;
+      procfs_data->gcmaxticks = dev->gcmaxticks;
       procfs_data->sectorsperblk = dev->sectorsPerBlk;
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -5271,6 +5524,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -5318,6 +5572,10 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+      sem_init(&dev->exclsem, 0, 1);
+      memset(&dev->gcwork, 0, sizeof(struct work_s));
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -5599,6 +5857,18 @@ static int smart_loteardown(FAR const char *devname)
 
   /* Now teardown the filemtd */
 
+#ifdef CONFIG_MTD_SMART_GC_WORKER
+  /* Make sure the background collector is not using the device.  Cancel
+   * again with the device locked in case a running worker requeued itself.
+   */
+
+  (void)work_cancel(LPWORK, &dev->gcwork);
+  smart_lock(dev);
+  (void)work_cancel(LPWORK, &dev->gcwork);
+  smart_unlock(dev);
+  sem_destroy(&dev->exclsem);
+#endif
+
   filemtd_teardown(dev->mtd);
   unregister_blockdriver(devname);
 
@@ -59,6 +59,10 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/loopback.h>
 
+#ifdef CONFIG_NETDEV_IOB
+#  include <nuttx/net/iob.h>
+#endif
+
 #ifdef CONFIG_NET_PKT
 #  include <nuttx/net/pkt.h>
 #endif
@@ -90,6 +94,17 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)priv->lo_dev.d_buf)
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)priv->lo_dev.d_buf)
 
+/* With the I/O buffer packet interface, packets "sent" during a poll are
+ * queued and then looped back as a batch when the poll completes.
+ */
+
+#ifdef CONFIG_NETDEV_IOB
+#  define lo_rxbatch(priv) \
+     (void)netdev_iob_input(&(priv)->lo_dev, &(priv)->lo_txq, lo_iobframe)
+#else
+#  define lo_rxbatch(priv)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -104,6 +119,9 @@ struct lo_driver_s
   bool lo_txdone;              /* One RX packet was looped back */
   WDOG_ID lo_polldog;          /* TX poll timer */
   struct work_s lo_work;       /* For deferring work to the work queue */
+#ifdef CONFIG_NETDEV_IOB
+  struct iob_queue_s lo_txq;   /* Packets waiting to be looped back */
+#endif
 
   /* This holds the information visible to the NuttX network */
 
@@ -123,6 +141,10 @@ static uint8_t g_iobuffer[MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE];
 
 /* Polling logic */
 
+static void lo_rxframe(FAR struct net_driver_s *dev);
+#ifdef CONFIG_NETDEV_IOB
+static void lo_iobframe(FAR struct net_driver_s *dev);
+#endif
 static int  lo_txpoll(FAR struct net_driver_s *dev);
 static void lo_poll_work(FAR void *arg);
 static void lo_poll_expiry(int argc, wdparm_t arg, ...);
@@ -144,6 +166,91 @@ static int lo_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: lo_rxframe
+ *
+ * Description:
+ *   Pass the packet in d_buf to the network as a received packet.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void lo_rxframe(FAR struct net_driver_s *dev)
+{
+  FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
+
+  NETDEV_RXPACKETS(&priv->lo_dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the packet tap */
+
+  pkt_input(&priv->lo_dev);
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(&priv->lo_dev);
+      ipv4_input(&priv->lo_dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("Iv6 frame\n");
+      NETDEV_RXIPV6(&priv->lo_dev);
+      ipv6_input(&priv->lo_dev);
+    }
+  else
+#endif
+    {
+      nwarn("WARNING: Unrecognized packet type dropped: %02x\n", IPv4BUF->vhl);
+      NETDEV_RXDROPPED(&priv->lo_dev);
+      priv->lo_dev.d_len = 0;
+    }
+}
+
+/****************************************************************************
+ * Function: lo_iobframe
+ *
+ * Description:
+ *   Pass a queued packet to the network.  This is the callback from
+ *   netdev_iob_input().  Any response is looped back in turn.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB
+static void lo_iobframe(FAR struct net_driver_s *dev)
+{
+  lo_rxframe(dev);
+  if (dev->d_len > 0)
+    {
+      (void)lo_txpoll(dev);
+    }
+}
+#endif
+
 /****************************************************************************
  * Function: lo_txpoll
  *
@@ -168,48 +275,44 @@ static int lo_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
 
-  /* Loop while there is data "sent", i.e., while d_len > 0.  That should be
-   * the case upon entry here and while the processing of the IPv4/6 packet
-   * generates a new packet to be sent.  Sending, of course, just means
-   * relaying back through the network for this driver.
+#ifdef CONFIG_NETDEV_IOB
+  /* Queue the packet so that the poll can move on to the next connection.
+   * The queued packets are looped back by lo_rxbatch() when the poll
+   * completes.
    */
 
-  while (priv->lo_dev.d_len > 0)
+  if (priv->lo_dev.d_len > 0)
     {
-       NETDEV_TXPACKETS(&priv->lo_dev);
-       NETDEV_RXPACKETS(&priv->lo_dev);
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the packet tap */
+      FAR struct iob_s *iob = netdev_iob_output(&priv->lo_dev);
 
-       pkt_input(&priv->lo_dev);
-#endif
-
-      /* We only accept IP packets of the configured type and ARP packets */
-
-#ifdef CONFIG_NET_IPv4
-      if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+      if (iob != NULL && iob_tryadd_queue(iob, &priv->lo_txq) >= 0)
         {
-          ninfo("IPv4 frame\n");
-          NETDEV_RXIPV4(&priv->lo_dev);
-          ipv4_input(&priv->lo_dev);
+          NETDEV_TXPACKETS(&priv->lo_dev);
+          priv->lo_dev.d_len = 0;
+          priv->lo_txdone    = true;
+          NETDEV_TXDONE(&priv->lo_dev);
+          return 0;
         }
-      else
-#endif
-#ifdef CONFIG_NET_IPv6
-      if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+
+      /* Out of I/O buffers.  Loop the packet back immediately. */
+
+      if (iob != NULL)
         {
-          ninfo("Iv6 frame\n");
-          NETDEV_RXIPV6(&priv->lo_dev);
-          ipv6_input(&priv->lo_dev);
+          iob_free_chain(iob);
         }
-      else
+    }
 #endif
-        {
-          nwarn("WARNING: Unrecognized packet type dropped: %02x\n", IPv4BUF->vhl);
-          NETDEV_RXDROPPED(&priv->lo_dev);
-          priv->lo_dev.d_len = 0;
-        }
+
+  /* Loop while there is data "sent", i.e., while d_len > 0.  That should be
+   * the case upon entry here and while the processing of the IPv4/6 packet
+   * generates a new packet to be sent.  Sending, of course, just means
+   * relaying back through the network for this driver.
+   */
+
+  while (priv->lo_dev.d_len > 0)
+    {
+      NETDEV_TXPACKETS(&priv->lo_dev);
+      lo_rxframe(&priv->lo_dev);
 
       priv->lo_txdone = true;
       NETDEV_TXDONE(&priv->lo_dev);
@@ -244,6 +347,7 @@ static void lo_poll_work(FAR void *arg)
   net_lock();
   priv->lo_txdone = false;
   (void)devif_timer(&priv->lo_dev, lo_txpoll);
+  lo_rxbatch(priv);
 
   /* Was something received and looped back? */
 
@@ -253,6 +357,7 @@ static void lo_poll_work(FAR void *arg)
 
       priv->lo_txdone = false;
       (void)devif_poll(&priv->lo_dev, lo_txpoll);
+      lo_rxbatch(priv);
     }
 
   /* Setup the watchdog poll timer again */
@@ -368,6 +473,12 @@ static int lo_ifdown(FAR struct net_driver_s *dev)
 
   wd_cancel(priv->lo_polldog);
 
+#ifdef CONFIG_NETDEV_IOB
+  /* Discard any packets that were never looped back */
+
+  iob_free_queue(&priv->lo_txq);
+#endif
+
   /* Mark the device "down" */
 
   priv->lo_bifup = false;
@@ -406,6 +517,7 @@ static void lo_txavail_work(FAR void *arg)
 
           priv->lo_txdone = false;
           (void)devif_poll(&priv->lo_dev, lo_txpoll);
+          lo_rxbatch(priv);
         }
       while (priv->lo_txdone);
     }
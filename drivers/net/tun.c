@@ -170,6 +170,7 @@ static void tun_poll_expiry(int argc, wdparm_t arg, ...);
 
 static int tun_ifup(FAR struct net_driver_s *dev);
 static int tun_ifdown(FAR struct net_driver_s *dev);
+static void tun_txavail_work(FAR void *arg);
 static int tun_txavail(FAR struct net_driver_s *dev);
 #if defined(CONFIG_NET_IGMP) || defined(CONFIG_NET_ICMPv6)
 static int tun_addmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
@@ -696,27 +697,25 @@ static int tun_ifdown(struct net_driver_s *dev)
 }
 
 /****************************************************************************
- * Function: tun_txavail
+ * Function: tun_txavail_work
  *
  * Description:
- *   Driver callback invoked when new TX data is available.  This is a
- *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
- *   latency.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   Called in normal user mode
+ *   Called on the higher priority worker thread.
  *
  ****************************************************************************/
 
-static int tun_txavail(struct net_driver_s *dev)
+static void tun_txavail_work(FAR void *arg)
 {
-  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)arg;
 
   tun_lock(priv);
 
@@ -725,7 +724,7 @@ static int tun_txavail(struct net_driver_s *dev)
   if (priv->read_d_len != 0 || priv->write_d_len != 0)
     {
       tun_unlock(priv);
-      return OK;
+      return;
     }
 
   net_lock();
@@ -740,6 +739,40 @@ static int tun_txavail(struct net_driver_s *dev)
 
   net_unlock();
   tun_unlock(priv);
+}
+
+/****************************************************************************
+ * Function: tun_txavail
+ *
+ * Description:
+ *   Driver callback invoked when new TX data is available.  This is a
+ *   stimulus perform an out-of-cycle poll and, thereby, reduce the TX
+ *   latency.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.  The device lock must be taken before
+ *   the network lock, so the poll is deferred to the work queue.
+ *
+ ****************************************************************************/
+
+static int tun_txavail(struct net_driver_s *dev)
+{
+  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)dev->d_private;
+
+  /* Is our single work structure available?  It may not be if there is a
+   * pending poll, in which case that poll will pick up the new data.
+   */
+
+  if (work_available(&priv->work))
+    {
+      work_queue(TUNWORK, &priv->work, tun_txavail_work, priv, 0);
+    }
 
   return OK;
 }
@@ -978,25 +1011,30 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
       return -EBUSY;
     }
 
-  net_lock();
-
   if (buflen > CONFIG_NET_TUN_MTU)
     {
       ret = -EINVAL;
     }
   else
     {
+      /* The device lock protects write_buf, so the packet can be copied
+       * in before the network is locked.
+       */
+
       memcpy(priv->write_buf, buffer, buflen);
 
+      net_lock();
+
       priv->dev.d_buf = priv->write_buf;
       priv->dev.d_len = buflen;
 
       tun_net_receive(priv);
 
+      net_unlock();
+
       ret = (ssize_t)buflen;
     }
 
-  net_unlock();
   tun_unlock(priv);
 
   return ret;
@@ -1062,7 +1100,9 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
       tun_lock(priv);
     }
 
-  net_lock();
+  /* The device lock protects read_buf, so the packet can be copied out
+   * before the network is locked.
+   */
 
   read_d_len = priv->read_d_len;
   if (buflen < read_d_len)
@@ -1076,8 +1116,9 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
     }
 
   priv->read_d_len = 0;
-  tun_txdone(priv);
 
+  net_lock();
+  tun_txdone(priv);
   net_unlock();
 
 out:
@@ -84,6 +84,7 @@
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t bufsize);
 
 /****************************************************************************
  * Private Functions
@@ -147,6 +148,92 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the pipe ring buffer.  If the buffer has already
+ *   been allocated, a new buffer is allocated and the unread data is
+ *   copied to the beginning of it so that the next transfers can use a
+ *   single contiguous copy.  The caller must hold d_bfsem.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t bufsize)
+{
+  FAR uint8_t *buffer;
+  size_t count;
+  size_t nbytes;
+  int sval;
+
+  /* The new size may not exceed the configured maximum and must be able to
+   * hold all of the data that is already in the pipe (plus the one slot
+   * that is always left empty).
+   */
+
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      count = (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
+    }
+  else
+    {
+      count = dev->d_wrndx - dev->d_rdndx;
+    }
+
+  if (bufsize < 2 || bufsize > CONFIG_DEV_PIPE_MAXSIZE || count >= bufsize)
+    {
+      return -EINVAL;
+    }
+
+  if (bufsize == dev->d_bufsize)
+    {
+      return OK;
+    }
+
+  /* If the buffer has not been allocated yet, then just remember the size
+   * that should be used when it is allocated by the first open.
+   */
+
+  if (dev->d_buffer == NULL)
+    {
+      dev->d_bufsize = bufsize;
+      return OK;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Copy the unread data, in at most two pieces, linearizing it */
+
+  nbytes = count;
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      nbytes = dev->d_bufsize - dev->d_rdndx;
+      memcpy(&buffer[nbytes], dev->d_buffer, dev->d_wrndx);
+    }
+
+  memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+
+  kmm_free(dev->d_buffer);
+  dev->d_buffer  = buffer;
+  dev->d_bufsize = bufsize;
+  dev->d_rdndx   = 0;
+  dev->d_wrndx   = count;
+
+  /* There may now be more space; wake up any writers waiting for it */
+
+  while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+    {
+      sem_post(&dev->d_wrsem);
+    }
+
+  pipecommon_pollnotify(dev, POLLOUT);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -428,6 +515,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
+  size_t                 nbytes;
   int                    sval;
   int                    ret;
 
@@ -483,13 +571,33 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   nread = 0;
   while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      /* Copy the contiguous region up to the write index or up to the end
+       * of the ring.  At most two passes are needed when the data wraps.
+       */
+
+      if (dev->d_wrndx > dev->d_rdndx)
         {
-          dev->d_rdndx = 0;
+          nbytes = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
+        {
+          nbytes = dev->d_bufsize - dev->d_rdndx;
         }
 
-      nread++;
+      if (nbytes > len - nread)
+        {
+          nbytes = len - nread;
+        }
+
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+      buffer       += nbytes;
+      nread        += nbytes;
+      dev->d_rdndx += nbytes;
+
+      if (dev->d_rdndx >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
     }
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
@@ -519,6 +627,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
+  size_t                 nbytes;
   int                    nxtwrndx;
   int                    sval;
 
@@ -556,26 +665,49 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Calculate the contiguous space following the write index.  One slot
+       * is always left empty so that a full buffer can be distinguished
+       * from an empty one.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      if (dev->d_wrndx >= dev->d_rdndx)
         {
-          nxtwrndx = 0;
+          nbytes = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              nbytes--;
+            }
+        }
+      else
+        {
+          nbytes = dev->d_rdndx - dev->d_wrndx - 1;
         }
 
       /* Would the next write overflow the circular buffer? */
 
-      if (nxtwrndx != dev->d_rdndx)
+      if (nbytes > 0)
         {
-          /* No... copy the byte */
+          /* No... copy as much as fits in the contiguous region */
+
+          if (nbytes > len - nwritten)
+            {
+              nbytes = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[dev->d_wrndx], buffer, nbytes);
+          buffer   += nbytes;
+          nwritten += nbytes;
+
+          nxtwrndx = dev->d_wrndx + nbytes;
+          if (nxtwrndx >= dev->d_bufsize)
+            {
+              nxtwrndx = 0;
+            }
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
           dev->d_wrndx = nxtwrndx;
 
           /* Is the write complete? */
 
-          nwritten++;
           if ((size_t)nwritten >= len)
             {
               /* Yes.. Notify all of the waiting readers that more data is available */
@@ -849,6 +981,19 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case PIPEIOC_GETSIZE:
+        {
+          *(FAR int *)((uintptr_t)arg) = dev->d_bufsize;
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, (size_t)arg);
+        }
+        break;
+
       default:
         break;
     }
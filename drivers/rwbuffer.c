@@ -51,6 +51,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/drivers/rwbuffer.h>
 
@@ -189,6 +190,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
   /* The following assumes that the size of a pointer is 4-bytes or less */
@@ -212,11 +214,9 @@ static void rwb_wrtimeout(FAR void *arg)
 
 static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 {
-  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds. CLK_TCK
-   * provides the clock tick of the system (frequency in Hz).
-   */
+  /* CONFIG_DRVR_WRDELAY provides the delay period in milliseconds */
 
-  int ticks = (CONFIG_DRVR_WRDELAY + CLK_TCK/2) / CLK_TCK;
+  int ticks = MSEC2TICK(CONFIG_DRVR_WRDELAY);
   (void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
 }
 
@@ -228,6 +228,7 @@ static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
   (void)work_cancel(LPWORK, &rwb->work);
 }
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
@@ -238,22 +239,32 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, uint32_t nblocks,
                                FAR const uint8_t *wrbuffer)
 {
-  int ret;
+  off_t  endblock;
+  off_t  wrbend;
+  off_t  offset;
+  int    ret;
 
   /* Write writebuffer Logic */
 
+  rwb_semtake(&rwb->wrsem);
   rwb_wrcanceltimeout(rwb);
 
-  /* First: Should we flush out our cache? We would do that if (1) we already
-   * buffering blocks and the next block writing is not in the same sequence,
-   * or (2) the number of blocks would exceed our allocated buffer capacity
+  /* First: Should we flush out our cache?  We can keep the buffered data
+   * if the new write overwrites or extends the buffered blocks and the
+   * result still fits in the buffer.  Otherwise we must flush it.  The end
+   * of the buffered data is recomputed here because an invalidation may
+   * have shortened it.
    */
 
-  if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) ||
-      ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks))
+  endblock = startblock + nblocks;
+  wrbend   = rwb->wrblockstart + rwb->wrnblocks;
+  if (rwb->wrnblocks > 0 &&
+      (startblock < rwb->wrblockstart ||
+       startblock > wrbend ||
+       endblock - rwb->wrblockstart > rwb->wrmaxblocks))
     {
       finfo("writebuffer miss, expected: %08x, given: %08x\n",
-            rwb->wrexpectedblock, startblock);
+            wrbend, startblock);
 
       /* Flush the write buffer */
 
@@ -261,6 +272,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
       if (ret < 0)
         {
           ferr("ERROR: Error writing multiple from cache: %d\n", -ret);
+          rwb_semgive(&rwb->wrsem);
           return ret;
         }
 
@@ -272,20 +284,26 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
   if (rwb->wrnblocks == 0)
     {
       finfo("Fresh cache starting at block: 0x%08x\n", startblock);
-      rwb->wrblockstart = startblock;
+      rwb->wrblockstart    = startblock;
+      rwb->wrexpectedblock = startblock;
     }
 
-  /* Add data to cache */
+  /* Add data to cache, replacing any blocks that are already buffered */
 
+  offset = (startblock - rwb->wrblockstart) * rwb->blocksize;
   finfo("writebuffer: copying %d bytes from %p to %p\n",
-        nblocks * rwb->blocksize, wrbuffer,
-        &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-  memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize],
-         wrbuffer, nblocks * rwb->blocksize);
+        nblocks * rwb->blocksize, wrbuffer, &rwb->wrbuffer[offset]);
+  memcpy(&rwb->wrbuffer[offset], wrbuffer, nblocks * rwb->blocksize);
+
+  if (endblock > rwb->wrblockstart + rwb->wrnblocks)
+    {
+      rwb->wrnblocks = endblock - rwb->wrblockstart;
+    }
 
-  rwb->wrnblocks      += nblocks;
   rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
+
   rwb_wrstarttimeout(rwb);
+  rwb_semgive(&rwb->wrsem);
   return nblocks;
 }
 #endif
@@ -302,6 +320,43 @@ static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
   rwb->rhnblocks    = 0;
   rwb->rhblockstart = (off_t)-1;
 }
+
+/****************************************************************************
+ * Name: rwb_rhupdate
+ *
+ * Description:
+ *   Copy newly written blocks into the read-ahead buffer where they overlap
+ *   it, so that the buffered data does not have to be discarded.
+ *
+ ****************************************************************************/
+
+static void rwb_rhupdate(FAR struct rwbuffer_s *rwb, off_t startblock,
+                         size_t nblocks, FAR const uint8_t *wrbuffer)
+{
+  off_t first;
+  off_t last;
+
+  /* We assume that the caller holds the rhsem */
+
+  first = startblock;
+  if (first < rwb->rhblockstart)
+    {
+      first = rwb->rhblockstart;
+    }
+
+  last = startblock + nblocks;
+  if (last > rwb->rhblockstart + rwb->rhnblocks)
+    {
+      last = rwb->rhblockstart + rwb->rhnblocks;
+    }
+
+  if (first < last)
+    {
+      memcpy(&rwb->rhbuffer[(first - rwb->rhblockstart) * rwb->blocksize],
+             &wrbuffer[(first - startblock) * rwb->blocksize],
+             (last - first) * rwb->blocksize);
+    }
+}
 #endif
 
 /****************************************************************************
@@ -343,7 +398,8 @@ rwb_bufferread(struct rwbuffer_s *rwb,  off_t startblock,
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock,
+                        size_t window)
 {
   off_t  endblock;
   size_t nblocks;
@@ -357,10 +413,15 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
     }
 
   /* Get the block number +1 of the last block that will fit in the
-   * read-ahead buffer
+   * read-ahead window
    */
 
-  endblock = startblock + rwb->rhmaxblocks;
+  if (window > rwb->rhmaxblocks)
+    {
+      window = rwb->rhmaxblocks;
+    }
+
+  endblock = startblock + window;
 
   /* Make sure that we don't read past the end of the device */
 
@@ -406,7 +467,7 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret;
+  int ret = OK;
 
   if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
     {
@@ -478,7 +539,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 
       else if (wrbend > startblock && wrbend <= invend)
         {
-          rwb->wrnblocks = wrbend - startblock;
+          rwb->wrnblocks = startblock - rwb->wrblockstart;
           ret = OK;
         }
 
@@ -542,7 +603,7 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
                                off_t startblock, size_t blockcount)
 {
-  int ret;
+  int ret = OK;
 
   if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0)
     {
@@ -691,6 +752,8 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
       /* Initialize read-ahead buffer parameters */
 
       rwb_resetrhbuffer(rwb);
+      rwb->rhwindow   = rwb->rhmaxblocks;
+      rwb->rhseqblock = (off_t)-1;
 
       /* Allocate the read-ahead buffer */
 
@@ -750,7 +813,10 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                  size_t nblocks, FAR uint8_t *rdbuffer)
 {
+#ifdef CONFIG_DRVR_READAHEAD
   size_t remaining;
+  bool sequential;
+#endif
   int ret = OK;
 
   finfo("startblock=%ld nblocks=%ld rdbuffer=%p\n",
@@ -782,9 +848,14 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 #ifdef CONFIG_DRVR_READAHEAD
   if (rwb->rhmaxblocks > 0)
     {
-      /* Loop until we have read all of the requested blocks */
+      /* Is this read a continuation of the previous one? */
 
       rwb_semtake(&rwb->rhsem);
+      sequential      = (startblock == rwb->rhseqblock);
+      rwb->rhseqblock = startblock + nblocks;
+
+      /* Loop until we have read all of the requested blocks */
+
       for (remaining = nblocks; remaining > 0; )
         {
           /* Is there anything in the read-ahead buffer? */
@@ -812,31 +883,78 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                 }
             }
 
-          /* If we did not get all of the data from the buffer, then we have
-           * to refill the buffer and try again.
+          if (remaining == 0)
+            {
+              break;
+            }
+
+          /* There is no point in staging a transfer that fills the whole
+           * read-ahead buffer.  Read it directly into the user buffer.
            */
 
-          if (remaining > 0)
+          if (remaining >= rwb->rhmaxblocks)
             {
-              ret = rwb_rhreload(rwb, startblock);
-              if (ret < 0)
+              ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, remaining);
+              if (ret != (int)remaining)
                 {
-                  ferr("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
-                  return (ssize_t)ret;
+                  ferr("ERROR: Failed to read %d blocks: %d\n", remaining, ret);
+                  ret = -EIO;
+                  break;
                 }
+
+              remaining = 0;
+              break;
             }
+
+          /* Otherwise refill the buffer and try again.  The read-ahead
+           * window grows while the access is sequential and shrinks when it
+           * is not, so random access does not pay for data it never uses.
+           */
+
+          if (sequential)
+            {
+              if (rwb->rhwindow < (rwb->rhmaxblocks >> 1))
+                {
+                  rwb->rhwindow <<= 1;
+                }
+              else
+                {
+                  rwb->rhwindow = rwb->rhmaxblocks;
+                }
+            }
+          else if (rwb->rhwindow > 1)
+            {
+              rwb->rhwindow >>= 1;
+            }
+
+          ret = rwb_rhreload(rwb, startblock,
+                             remaining > rwb->rhwindow ? remaining :
+                             rwb->rhwindow);
+          if (ret < 0)
+            {
+              ferr("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+              break;
+            }
+
+          /* Anything more needed by this request is sequential */
+
+          sequential = true;
         }
 
+      rwb_semgive(&rwb->rhsem);
+
       /* On success, return the number of blocks that we were requested to
        * read. This is for compatibility with the normal return of a block
        * driver read method
        */
 
-      rwb_semgive(&rwb->rhsem);
-      ret = nblocks;
+      if (ret >= 0)
+        {
+          ret = nblocks;
+        }
     }
   else
-#else
+#endif
     {
       /* No read-ahead buffering, (re)load the data directly into
        * the user buffer.
@@ -844,7 +962,6 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
     }
-#endif
 
   return (ssize_t)ret;
 }
@@ -858,25 +975,6 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 {
   int ret = OK;
 
-#ifdef CONFIG_DRVR_READAHEAD
-  if (rwb->rhmaxblocks > 0)
-    {
-      /* If the new write data overlaps any part of the read buffer, then
-       * flush the data from the read buffer.  We could attempt some more
-       * exotic handling -- but this simple logic is well-suited for simple
-       * streaming applications.
-       */
-
-      rwb_semtake(&rwb->rhsem);
-      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
-        {
-          rwb_resetrhbuffer(rwb);
-        }
-
-      rwb_semgive(&rwb->rhsem);
-    }
-#endif
-
 #ifdef CONFIG_DRVR_WRITEBUFFER
   if (rwb->wrmaxblocks > 0)
     {
@@ -909,7 +1007,7 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
        */
     }
   else
-#else
+#endif
     {
       /* No write buffer.. just pass the write operation through via the
        * flush callback.
@@ -917,6 +1015,31 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
     }
+
+#ifdef CONFIG_DRVR_READAHEAD
+  if (rwb->rhmaxblocks > 0)
+    {
+      /* If the new write data overlaps any part of the read buffer, then
+       * update the read buffer with the new data.  If the write failed,
+       * then we no longer know what is on the media and just discard the
+       * read buffer.
+       */
+
+      rwb_semtake(&rwb->rhsem);
+      if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks))
+        {
+          if (ret < 0)
+            {
+              rwb_resetrhbuffer(rwb);
+            }
+          else
+            {
+              rwb_rhupdate(rwb, startblock, nblocks, wrbuffer);
+            }
+        }
+
+      rwb_semgive(&rwb->rhsem);
+    }
 #endif
 
   return (ssize_t)ret;
@@ -96,7 +96,7 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
       status = sigqueue(pid, aiocbp->aio_sigevent.sigev_signo,
                         aiocbp->aio_sigevent.sigev_value);
 #else
-      status = sigqueue(pid, aiocbp->aio_sigevent.sigev_sign,
+      status = sigqueue(pid, aiocbp->aio_sigevent.sigev_signo,
                         aiocbp->aio_sigevent.sigev_value.sival_ptr);
 #endif
       if (status < 0)
@@ -141,44 +141,20 @@ static inline int readpseudodir(struct fs_dirent_s *idir)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: readdir
+ * Name: readdir_next
  *
  * Description:
- *   The readdir() function returns a pointer to a dirent structure
- *   representing the next directory entry in the directory stream pointed
- *   to by dir.  It returns NULL on reaching the end-of-file or if an error
- *   occurred.
- *
- * Inputs:
- *   dirp -- An instance of type DIR created by a previous call to opendir();
- *
- * Return:
- *   The readdir() function returns a pointer to a dirent structure, or NULL
- *   if an error occurs or end-of-file is reached.  On error, errno is set
- *   appropriately.
- *
- *   EBADF   - Invalid directory stream descriptor dir
+ *   Read the next entry of the directory into idir->fd_dir.  Returns zero
+ *   on success, -ENOENT at the end of the directory, or another negated
+ *   errno value on failure.
  *
  ****************************************************************************/
 
-FAR struct dirent *readdir(DIR *dirp)
+static int readdir_next(FAR struct fs_dirent_s *idir)
 {
-  FAR struct fs_dirent_s *idir = (struct fs_dirent_s *)dirp;
   struct inode *inode;
   int ret;
 
-  /* Verify that we were provided with a valid directory structure */
-
-  if (!idir)
-    {
-      ret = EBADF;
-      goto errout;
-    }
-
   /* A special case is when we enumerate an "empty", unused inode.  That is
    * an inode in the pseudo-filesystem that has no operations and no children.
    * This is a "dangling" directory entry that has lost its children.
@@ -191,8 +167,7 @@ FAR struct dirent *readdir(DIR *dirp)
        * with readdir.  We return NULL to signal either case.
        */
 
-      ret = OK;
-      goto errout;
+      return -ENOENT;
     }
 
   /* The way we handle the readdir depends on the type of inode
@@ -208,8 +183,7 @@ FAR struct dirent *readdir(DIR *dirp)
 
       if (!inode->u.i_mops || !inode->u.i_mops->readdir)
         {
-          ret = EACCES;
-          goto errout;
+          return -EACCES;
         }
 
       /* Perform the readdir() operation */
@@ -224,29 +198,169 @@ FAR struct dirent *readdir(DIR *dirp)
       ret = readpseudodir(idir);
     }
 
+  if (ret >= 0)
+    {
+      idir->fd_position++;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readdir
+ *
+ * Description:
+ *   The readdir() function returns a pointer to a dirent structure
+ *   representing the next directory entry in the directory stream pointed
+ *   to by dir.  It returns NULL on reaching the end-of-file or if an error
+ *   occurred.
+ *
+ * Inputs:
+ *   dirp -- An instance of type DIR created by a previous call to opendir();
+ *
+ * Return:
+ *   The readdir() function returns a pointer to a dirent structure, or NULL
+ *   if an error occurs or end-of-file is reached.  On error, errno is set
+ *   appropriately.
+ *
+ *   EBADF   - Invalid directory stream descriptor dir
+ *
+ ****************************************************************************/
+
+FAR struct dirent *readdir(DIR *dirp)
+{
+  FAR struct fs_dirent_s *idir = (struct fs_dirent_s *)dirp;
+  int ret;
+
+  /* Verify that we were provided with a valid directory structure */
+
+  if (!idir)
+    {
+      set_errno(EBADF);
+      return NULL;
+    }
+
   /* ret < 0 is an error.  Special case: ret = -ENOENT is end of file */
 
+  ret = readdir_next(idir);
   if (ret < 0)
     {
-      if (ret == -ENOENT)
+      set_errno(ret == -ENOENT ? OK : -ret);
+      return NULL;
+    }
+
+  /* Success */
+
+  return &idir->fd_dir;
+}
+
+/****************************************************************************
+ * Name: readdirstat
+ *
+ * Description:
+ *   The readdirstat() function is a non-standard interface that returns up
+ *   to nentries directory entries, each together with the information that
+ *   stat() would return for it, in one call.  This avoids the readdir()
+ *   call and the full path resolution of a stat() call per entry.
+ *
+ *   File systems that have the information at hand when they read the
+ *   directory entry (FAT, SmartFS, tmpfs, procfs) return the complete
+ *   status.  For the others, only the file type is returned in st_mode.
+ *
+ * Inputs:
+ *   dirp     -- An instance of type DIR created by a previous call to
+ *               opendir();
+ *   entries  -- The location to return the entries
+ *   nentries -- The maximum number of entries to return
+ *
+ * Return:
+ *   The number of entries returned.  Zero is returned at the end of the
+ *   directory.  On error, -1 is returned and errno is set appropriately.
+ *
+ *   EBADF   - Invalid directory stream descriptor dir
+ *   EINVAL  - Invalid entries or nentries
+ *
+ ****************************************************************************/
+
+int readdirstat(FAR DIR *dirp, FAR struct direntstat *entries, int nentries)
+{
+  FAR struct fs_dirent_s *idir = (struct fs_dirent_s *)dirp;
+  FAR struct direntstat *entry;
+  FAR struct stat *buf;
+  uint8_t dtype;
+  int nread;
+  int ret = OK;
+
+  if (!idir)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (!entries || nentries <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  for (nread = 0; nread < nentries; nread++)
+    {
+      entry = &entries[nread];
+      buf   = &entry->ds_stat;
+
+      memset(buf, 0, sizeof(struct stat));
+      idir->fd_stat = buf;
+      ret = readdir_next(idir);
+      idir->fd_stat = NULL;
+
+      if (ret < 0)
         {
-          ret = OK;
+          break;
         }
-      else
+
+      memcpy(&entry->ds_dirent, &idir->fd_dir, sizeof(struct dirent));
+
+      /* If the file system did not provide the status, at least return
+       * the file type.
+       */
+
+      if (buf->st_mode == 0)
         {
-          ret = -ret;
+          dtype = idir->fd_dir.d_type;
+          if (DIRENT_ISDIRECTORY(dtype))
+            {
+              buf->st_mode = S_IFDIR;
+            }
+          else if (DIRENT_ISFILE(dtype))
+            {
+              buf->st_mode = S_IFREG;
+            }
+          else if (DIRENT_ISCHR(dtype))
+            {
+              buf->st_mode = S_IFCHR;
+            }
+          else if (DIRENT_ISBLK(dtype))
+            {
+              buf->st_mode = S_IFBLK;
+            }
+          else if (DIRENT_ISLINK(dtype))
+            {
+              buf->st_mode = S_IFLNK;
+            }
         }
-
-      goto errout;
     }
 
-  /* Success */
+  /* Report an error only if no entries were returned */
 
-  idir->fd_position++;
-  return &idir->fd_dir;
+  if (nread == 0 && ret < 0 && ret != -ENOENT)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
 
-errout:
-  set_errno(ret);
-  return NULL;
+  return nread;
 }
-
@@ -1806,6 +1806,15 @@ static int fat_readdir(FAR struct inode *mountpt, FAR struct fs_dirent_s *dir)
                   dir->fd_dir.d_type = DTYPE_DIRECTORY;
                 }
 
+              /* Return the status of the entry too, if it was requested.
+               * Everything needed is in the short file name entry.
+               */
+
+              if (dir->fd_stat != NULL)
+                {
+                  (void)fat_stat_file(fs, direntry, dir->fd_stat);
+                }
+
               /* Mark the entry found.  We will set up the next directory index,
                * and then exit with success.
                */
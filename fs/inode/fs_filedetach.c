@@ -157,6 +157,13 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
 
+  /* Lower the free descriptor hint used by files_allocate() */
+
+  if (fd < list->fl_minfree)
+    {
+      list->fl_minfree = fd;
+    }
+
   _files_semgive(list);
   return OK;
 }
@@ -79,6 +79,34 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) sem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_setfree
+ *
+ * Description:
+ *   Note that the file structure 'filep' has been released.  If 'filep' lies
+ *   in 'list', then lower the free descriptor hint used by files_allocate()
+ *   if necessary.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static inline void _files_setfree(FAR struct filelist *list,
+                                  FAR struct file *filep)
+{
+  if (list != NULL && filep >= list->fl_files &&
+      filep < &list->fl_files[CONFIG_NFILE_DESCRIPTORS])
+    {
+      int fd = filep - list->fl_files;
+
+      if (fd < list->fl_minfree)
+        {
+          list->fl_minfree = fd;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -152,6 +180,10 @@ void files_initlist(FAR struct filelist *list)
   /* Initialize the list access mutex */
 
   (void)sem_init(&list->fl_sem, 0, 1);
+
+  /* All descriptors are free */
+
+  list->fl_minfree = 0;
 }
 
 /****************************************************************************
@@ -287,6 +319,9 @@ errout_with_inode:
   filep2->f_inode  = NULL;
 
 errout_with_ret:
+  /* filep2 was closed in either case */
+
+  _files_setfree(list, filep2);
   errcode              = -ret;
 
   if (list != NULL)
@@ -306,6 +341,10 @@ errout:
  *   Allocate a struct files instance and associate it with an inode instance.
  *   Returns the file descriptor == index into the files array.
  *
+ *   The search begins at the free descriptor hint (fl_minfree) rather than
+ *   at zero so that tasks with many open files do not rescan all of the
+ *   descriptors that are known to be in use on every allocation.
+ *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
@@ -319,7 +358,11 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
   DEBUGASSERT(list != NULL);
 
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+
+  /* All descriptors below fl_minfree are in use */
+
+  i = minfd < list->fl_minfree ? list->fl_minfree : minfd;
+  for (; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       if (!list->fl_files[i].f_inode)
         {
@@ -327,6 +370,16 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
            list->fl_files[i].f_pos    = pos;
            list->fl_files[i].f_inode  = inode;
            list->fl_files[i].f_priv   = NULL;
+
+           /* If the search began at the hint, then every descriptor up to
+            * and including this one is now in use.
+            */
+
+           if (minfd <= list->fl_minfree)
+             {
+               list->fl_minfree = i + 1;
+             }
+
            _files_semgive(list);
            return i;
         }
@@ -370,6 +423,7 @@ int files_close(int fd)
 
   _files_semtake(list);
   ret = _files_close(&list->fl_files[fd]);
+  _files_setfree(list, &list->fl_files[fd]);
   _files_semgive(list);
   return ret;
 }
@@ -396,6 +450,7 @@ void files_release(int fd)
       list->fl_files[fd].f_oflags  = 0;
       list->fl_files[fd].f_pos     = 0;
       list->fl_files[fd].f_inode = NULL;
+      _files_setfree(list, &list->fl_files[fd]);
       _files_semgive(list);
     }
 }
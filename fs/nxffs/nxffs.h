@@ -52,6 +52,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_PACK_WORKER
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -301,6 +305,10 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+  bool                      reclaim;   /* Deleted or orphaned data may be on FLASH */
+#ifdef CONFIG_NXFFS_PACK_WORKER
+  struct work_s             packwork;  /* Supports packing on the work queue */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1059,6 +1067,28 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_packschedule
+ *
+ * Description:
+ *   Schedule packing of the volume on the low priority work queue after
+ *   the volume has been idle for CONFIG_NXFFS_PACK_DELAY milliseconds.
+ *   Each call restarts the delay.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_WORKER
+void nxffs_packschedule(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_packschedule(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
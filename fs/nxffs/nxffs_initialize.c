@@ -178,8 +178,9 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
 
   /* Initialize the NXFFS volume structure */
 
-  volume->mtd    = mtd;
-  volume->cblock = (off_t)-1;
+  volume->mtd     = mtd;
+  volume->cblock  = (off_t)-1;
+  volume->reclaim = true;   /* Unknown until the first pack */
   sem_init(&volume->exclsem, 0, 1);
   sem_init(&volume->wrsem, 0, 1);
 
@@ -559,6 +560,14 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_PACK_WORKER
+  (void)work_cancel(LPWORK, &g_volume.packwork);
+#endif
+  return OK;
 #endif
 }
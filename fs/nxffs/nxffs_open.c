@@ -909,6 +909,13 @@ static inline int nxffs_wrclose(FAR struct nxffs_volume_s *volume,
   /* The volume is now available for other writers */
 
 errout:
+  if (ret < 0)
+    {
+      /* Any data written for the file is now orphaned */
+
+      volume->reclaim = true;
+    }
+
   sem_post(&volume->wrsem);
   return ret;
 }
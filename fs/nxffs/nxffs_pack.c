@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 
 #include "nxffs.h"
 
@@ -178,6 +179,38 @@ static inline bool nxffs_packvalid(FAR struct nxffs_pack_s *pack)
           blkhdr->state == BLOCK_STATE_GOOD);
 }
 
+/****************************************************************************
+ * Name: nxffs_packerased
+ *
+ * Description:
+ *   Check if the remainder of the current I/O block, beginning at the
+ *   current I/O offset, is already in the erased state.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   pack   - The volume packing state structure.
+ *
+ * Returned Values:
+ *   True if the remainder of the block is erased.
+ *
+ ****************************************************************************/
+
+static inline bool nxffs_packerased(FAR struct nxffs_volume_s *volume,
+                                    FAR struct nxffs_pack_s *pack)
+{
+  int i;
+
+  for (i = pack->iooffset; i < volume->geo.blocksize; i++)
+    {
+      if (pack->iobuffer[i] != CONFIG_NXFFS_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
  * Name: nxffs_mediacheck
  *
@@ -1271,9 +1304,20 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   off_t eblock;
   off_t block;
   bool packed;
+  bool unchanged;
   int i;
   int ret = OK;
 
+  /* There is nothing to gain if nothing has been deleted or orphaned since
+   * the volume was last packed.
+   */
+
+  if (!volume->reclaim)
+    {
+      finfo("Nothing to reclaim\n");
+      return OK;
+    }
+
   /* Get the offset to the first valid inode entry */
 
   wrfile = NULL;
@@ -1327,6 +1371,7 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
                   volume->froffset =
                     block * volume->geo.blocksize + SIZEOF_NXFFS_BLOCK_HDR;
+                  volume->reclaim  = false;
                 }
             }
 
@@ -1375,6 +1420,7 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
           else
             {
+              volume->reclaim = false;
               return OK;
             }
         }
@@ -1409,6 +1455,13 @@ start_pack:
 
       pack.block0 = eblock * volume->blkper;
 
+      /* Once everything has been packed, the remaining erase blocks only
+       * need to be cleaned.  Those that are already clean need not be
+       * erased and re-written.
+       */
+
+      unchanged = (packed && wrfile == NULL);
+
 #ifndef CONFIG_NXFFS_NAND
       /* Read the erase block into the pack buffer.  We need to do this even
        * if we are overwriting the entire block so that we skip over
@@ -1448,6 +1501,7 @@ start_pack:
 
               ferr("ERROR: Failed to read block %d: %d\n", block, ret);
               nxffs_blkinit(volume, pack.iobuffer, BLOCK_STATE_BAD);
+              unchanged = false;
             }
         }
 #endif
@@ -1560,6 +1614,11 @@ start_pack:
 
               if (pack.iooffset < volume->geo.blocksize)
                 {
+                  if (unchanged && !nxffs_packerased(volume, &pack))
+                    {
+                      unchanged = false;
+                    }
+
                   memset(&pack.iobuffer[pack.iooffset],
                          CONFIG_NXFFS_ERASEDSTATE,
                          volume->geo.blocksize - pack.iooffset);
@@ -1573,6 +1632,14 @@ start_pack:
             }
         }
 
+      /* Skip the erase block if the image is the same as on FLASH */
+
+      if (unchanged)
+        {
+          finfo("Erase block %d is already clean\n", eblock);
+          continue;
+        }
+
       /* We now have an in-memory image of how we want this erase block to
        * appear. Now it is safe to erase the block.
        */
@@ -1596,8 +1663,85 @@ start_pack:
         }
     }
 
+  /* Everything reclaimable has been reclaimed */
+
+  volume->reclaim = false;
+
 errout_with_pack:
   nxffs_freeentry(&pack.src.entry);
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_packworker
+ *
+ * Description:
+ *   Pack the volume from the low priority work queue.  Packing is deferred
+ *   while any file is open:  Packing relocates inodes, but open readers
+ *   keep the data offsets that were found when the file was opened.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_WORKER
+static void nxffs_packworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  /* Don't compete with a writer.  Try again when it may have finished. */
+
+  if (sem_trywait(&volume->wrsem) < 0)
+    {
+      nxffs_packschedule(volume);
+      return;
+    }
+
+  ret = sem_wait(&volume->exclsem);
+  if (ret == OK)
+    {
+      /* Nor with a reader.  Try again after the file has been closed. */
+
+      if (volume->ofiles != NULL)
+        {
+          sem_post(&volume->exclsem);
+          sem_post(&volume->wrsem);
+          nxffs_packschedule(volume);
+          return;
+        }
+
+      ret = nxffs_pack(volume);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to pack the volume: %d\n", -ret);
+        }
+
+      sem_post(&volume->exclsem);
+    }
+
+  sem_post(&volume->wrsem);
+}
+
+/****************************************************************************
+ * Name: nxffs_packschedule
+ *
+ * Description:
+ *   Schedule packing of the volume on the low priority work queue after
+ *   the volume has been idle for CONFIG_NXFFS_PACK_DELAY milliseconds.
+ *   Each call restarts the delay.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_packschedule(FAR struct nxffs_volume_s *volume)
+{
+  (void)work_cancel(LPWORK, &volume->packwork);
+  (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                   MSEC2TICK(CONFIG_NXFFS_PACK_DELAY));
+}
+#endif /* CONFIG_NXFFS_PACK_WORKER */
@@ -129,6 +129,13 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+  else
+    {
+      /* There is now something for the packer to reclaim */
+
+      volume->reclaim = true;
+      nxffs_packschedule(volume);
+    }
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -612,9 +612,11 @@ int nxffs_wrreserve(FAR struct nxffs_volume_s *volume, size_t size)
         }
 
       /* This is not the last block in the volume, so just seek to the
-       * beginning of the next, valid block.
+       * beginning of the next, valid block.  The space left at the end of
+       * this block can be recovered by packing.
        */
 
+      volume->reclaim = true;
       volume->ioblock++;
       ret = nxffs_validblock(volume, &volume->ioblock);
       if (ret < 0)
@@ -740,6 +742,10 @@ int nxffs_wrverify(FAR struct nxffs_volume_s *volume, size_t size)
                 {
                   nerased  = 0;
                   iooffset = i + 1;
+
+                  /* The space skipped here can be recovered by packing */
+
+                  volume->reclaim = true;
                 }
             }
         }
@@ -747,9 +753,11 @@ int nxffs_wrverify(FAR struct nxffs_volume_s *volume, size_t size)
       /* If we get here, then either (1) this block is not read-able, or
        * (2) we have looked at every byte in the block and did not find
        * any sequence of erased bytes long enough to hold the object.
-       * Skip to the next, valid block.
+       * Skip to the next, valid block.  Whatever was skipped can be
+       * recovered by packing.
        */
 
+      volume->reclaim = true;
       volume->ioblock++;
       ret = nxffs_validblock(volume, &volume->ioblock);
       if (ret < 0)
@@ -884,6 +884,23 @@ static int procfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
       ret = priv->procfsentry->ops->readdir(dir);
     }
 
+  /* Everything in the procfs is read-only, so the status of the entry
+   * follows from its type.
+   */
+
+  if (ret == OK && dir->fd_stat != NULL)
+    {
+      dir->fd_stat->st_mode = S_IROTH | S_IRGRP | S_IRUSR;
+      if (DIRENT_ISDIRECTORY(dir->fd_dir.d_type))
+        {
+          dir->fd_stat->st_mode |= S_IFDIR;
+        }
+      else
+        {
+          dir->fd_stat->st_mode |= S_IFREG;
+        }
+    }
+
   return ret;
 }
 
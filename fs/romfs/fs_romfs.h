@@ -129,6 +129,21 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+/* One entry of the hashed directory index.  Entries are chained by the
+ * 1-based index of the next entry in the same hash bucket (zero ends the
+ * chain).
+ */
+
+struct romfs_index_s
+{
+  uint32_t ri_parent;               /* First entry offset of the containing directory */
+  uint32_t ri_offset;               /* Offset of this entry's file header */
+  uint32_t ri_hash;                 /* Hash of the entry name */
+  uint32_t ri_next;                 /* Next entry in the hash bucket */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -149,6 +164,13 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_INDEX
+  FAR struct romfs_index_s *rm_index; /* Hashed directory index (may be NULL) */
+  FAR uint32_t *rm_buckets;         /* Hash bucket heads (1-based index) */
+  uint32_t rm_bucketmask;           /* Number of hash buckets minus one */
+  FAR uint32_t *rm_unindexed;       /* Directories searched without the index */
+  uint32_t rm_nunindexed;           /* Number of entries in rm_unindexed */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -223,6 +245,10 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_INDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
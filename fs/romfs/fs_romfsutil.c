@@ -277,6 +277,212 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_hash
+ *
+ * Desciption:
+ *   Return the FNV-1a hash of a (not necessarily terminated) name segment
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static uint32_t romfs_hash(FAR const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_bucket
+ *
+ * Desciption:
+ *   Return the hash bucket for a name in the directory whose first entry
+ *   is at 'parent'
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static inline uint32_t romfs_bucket(FAR struct romfs_mountpt_s *rm,
+                                    uint32_t parent, uint32_t hash)
+{
+  return (hash ^ (parent >> 4)) & rm->rm_bucketmask;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Desciption:
+ *   This is the indexed version of romfs_searchdir.  Only the entries of
+ *   the directory whose name hashes match are read from the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_index_s *entry;
+  uint32_t parent;
+  uint32_t hash;
+  uint32_t ndx;
+  int ret;
+
+  parent = dirinfo->rd_dir.fr_firstoffset;
+
+  /* Directories that could not be indexed completely must be searched on
+   * the media.
+   */
+
+  for (ndx = 0; ndx < rm->rm_nunindexed; ndx++)
+    {
+      if (rm->rm_unindexed[ndx] == parent)
+        {
+          return -EAGAIN;
+        }
+    }
+
+  hash = romfs_hash(entryname, entrylen);
+
+  for (ndx = rm->rm_buckets[romfs_bucket(rm, parent, hash)];
+       ndx != 0;
+       ndx = entry->ri_next)
+    {
+      entry = &rm->rm_index[ndx - 1];
+      if (entry->ri_parent == parent && entry->ri_hash == hash)
+        {
+          /* Probably a match, but the name still has to be verified */
+
+          ret = romfs_checkentry(rm, entry->ri_offset, entryname, entrylen,
+                                 dirinfo);
+          if (ret != -ENOENT)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* The index holds every readable entry of this directory so there is no
+   * need to search the media.
+   */
+
+  return -ENOENT;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_indexdir
+ *
+ * Desciption:
+ *   Append all of the entries of the directory whose first entry is at
+ *   'parent' to the index under construction.  An entry whose name cannot
+ *   be read is skipped.  If the rest of the directory cannot be reached,
+ *   the entries found so far are kept and the directory is added to the
+ *   list of directories that are searched without the index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static int romfs_indexdir(struct romfs_mountpt_s *rm, uint32_t parent,
+                          FAR struct romfs_index_s **pindex,
+                          FAR uint32_t *pnentries, FAR uint32_t *pnalloc)
+{
+  FAR struct romfs_index_s *index = *pindex;
+  FAR struct romfs_index_s *entry;
+  FAR uint32_t *unindexed;
+  char name[NAME_MAX+1];
+  uint32_t offset;
+  uint32_t next;
+  int16_t  ndx;
+  int      ret;
+
+  offset = parent;
+  do
+    {
+      /* There cannot be more entries than 16-byte chunks in the volume;
+       * more than that means that the image is corrupted and has a loop.
+       */
+
+      if (*pnentries >= rm->rm_volsize / ROMFS_ALIGNMENT)
+        {
+          ret = -EIO;
+          goto errout_unindexed;
+        }
+
+      /* Grow the index if necessary */
+
+      if (*pnentries >= *pnalloc)
+        {
+          uint32_t nalloc = *pnalloc ? 2 * *pnalloc : 32;
+
+          index = (FAR struct romfs_index_s *)
+            kmm_realloc(index, nalloc * sizeof(struct romfs_index_s));
+          if (index == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          *pindex  = index;
+          *pnalloc = nalloc;
+        }
+
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          ret = ndx;
+          goto errout_unindexed;
+        }
+
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+      ret = romfs_parsefilename(rm, offset, name);
+      if (ret < 0)
+        {
+          fwarn("WARNING: Skipping bad entry at %08lx: %d\n",
+                (unsigned long)offset, ret);
+        }
+      else
+        {
+          entry            = &index[*pnentries];
+          entry->ri_parent = parent;
+          entry->ri_offset = offset;
+          entry->ri_hash   = romfs_hash(name, strlen(name));
+          entry->ri_next   = 0;
+          (*pnentries)++;
+        }
+
+      offset = next;
+    }
+  while (next != 0);
+
+  return OK;
+
+errout_unindexed:
+  fwarn("WARNING: Directory %08lx not indexed: %d\n",
+        (unsigned long)parent, ret);
+
+  unindexed = (FAR uint32_t *)
+    kmm_realloc(rm->rm_unindexed, (rm->rm_nunindexed + 1) * sizeof(uint32_t));
+  if (unindexed == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  unindexed[rm->rm_nunindexed++] = parent;
+  rm->rm_unindexed = unindexed;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -295,6 +501,19 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Use the directory index if one was built when the volume was mounted */
+
+  if (rm->rm_index != NULL)
+    {
+      ret = romfs_searchindex(rm, entryname, entrylen, dirinfo);
+      if (ret != -EAGAIN)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -826,6 +1045,14 @@ int romfs_parsedirentry(struct romfs_mountpt_s *rm, uint32_t offset,
       return ret;
     }
 
+  /* The real file header may be in a different sector than the link */
+
+  ndx = romfs_devcacheread(rm, *poffset);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
   /* Because everything is chunked and aligned to 16-bit boundaries,
    * we know that most the basic node info fits into the sector.  The
    * associated name may not, however.
@@ -963,3 +1190,165 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Desciption:
+ *   Walk the whole directory tree of the mounted volume and build the
+ *   hashed directory index used by romfs_finddirentry().  This is done
+ *   once at mount time.  Bad entries are skipped and directories that
+ *   cannot be read completely are searched on the media; only if memory
+ *   runs out is no index kept, in which case all lookups use the linear
+ *   directory search.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_index_s *index = NULL;
+  FAR struct romfs_index_s *entry;
+  FAR uint32_t *buckets;
+  char name[NAME_MAX+1];
+  uint32_t nentries = 0;
+  uint32_t nalloc = 0;
+  uint32_t nbuckets;
+  uint32_t linkoffset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  uint32_t bucket;
+  uint32_t i;
+  int ret;
+
+  /* Index the root directory.  The index itself then serves as the queue
+   * of directories still to be visited:  Each entry that is a real
+   * sub-directory (not a "." or ".." hard link) appends its contents.
+   */
+
+  ret = romfs_indexdir(rm, rm->rm_rootoffset, &index, &nentries, &nalloc);
+
+  for (i = 0; ret >= 0 && i < nentries; i++)
+    {
+      /* An entry that cannot be parsed is not followed; a lookup through
+       * it will fail on the same error.
+       */
+
+      entry = &index[i];
+      if (romfs_parsedirentry(rm, entry->ri_offset, &linkoffset, &next,
+                              &info, &size) < 0 ||
+          linkoffset != entry->ri_offset || !IS_DIRECTORY(next) ||
+          info == 0 || info == entry->ri_parent)
+        {
+          continue;
+        }
+
+      if (romfs_parsefilename(rm, entry->ri_offset, name) < 0 ||
+          strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+        {
+          continue;
+        }
+
+      ret = romfs_indexdir(rm, info, &index, &nentries, &nalloc);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_index;
+    }
+
+  /* If nothing could be indexed, keep no index at all.  This also avoids
+   * shrinking the index to zero bytes below, which would free it.
+   */
+
+  if (nentries == 0)
+    {
+      ret = -ENOENT;
+      goto errout_with_index;
+    }
+
+  /* Use a power-of-two number of buckets, about one per entry */
+
+  for (nbuckets = 1; nbuckets < nentries; nbuckets <<= 1);
+
+  buckets = (FAR uint32_t *)kmm_zalloc(nbuckets * sizeof(uint32_t));
+  if (buckets == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_index;
+    }
+
+  /* Release the unused part of the index */
+
+  entry = (FAR struct romfs_index_s *)
+    kmm_realloc(index, nentries * sizeof(struct romfs_index_s));
+  if (entry != NULL)
+    {
+      index = entry;
+    }
+
+  rm->rm_index      = index;
+  rm->rm_buckets    = buckets;
+  rm->rm_bucketmask = nbuckets - 1;
+
+  /* Then link each entry into its hash bucket */
+
+  for (i = 0; i < nentries; i++)
+    {
+      entry          = &index[i];
+      bucket         = romfs_bucket(rm, entry->ri_parent, entry->ri_hash);
+      entry->ri_next = buckets[bucket];
+      buckets[bucket] = i + 1;
+    }
+
+  finfo("Indexed %lu entries in %lu buckets\n",
+        (unsigned long)nentries, (unsigned long)nbuckets);
+  return OK;
+
+errout_with_index:
+  if (index != NULL)
+    {
+      kmm_free(index);
+    }
+
+  if (rm->rm_unindexed != NULL)
+    {
+      kmm_free(rm->rm_unindexed);
+      rm->rm_unindexed  = NULL;
+      rm->rm_nunindexed = 0;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Desciption:
+ *   Free the directory index, if any
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index != NULL)
+    {
+      kmm_free(rm->rm_index);
+      kmm_free(rm->rm_buckets);
+
+      rm->rm_index   = NULL;
+      rm->rm_buckets = NULL;
+    }
+
+  if (rm->rm_unindexed != NULL)
+    {
+      kmm_free(rm->rm_unindexed);
+
+      rm->rm_unindexed  = NULL;
+      rm->rm_nunindexed = 0;
+    }
+}
+#endif
@@ -356,6 +356,9 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
         struct smartfs_entry_s *direntry, const char *relpath,
         uint16_t *parentdirsector, const char **filename);
 
+int smartfs_datlen(struct smartfs_mountpt_s *fs, uint16_t firstsector,
+        FAR uint32_t *datlen);
+
 int smartfs_createentry(struct smartfs_mountpt_s *fs,
         uint16_t parentdirsector, const char* filename,
         uint16_t type,
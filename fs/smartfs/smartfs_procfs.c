@@ -56,6 +56,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/dirent.h>
@@ -835,6 +836,8 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                                          "Free Sectors:      %d\nReleased Sectors:  %d\n"
                                          "Unused Sectors:    %d\nBlock Erases:      %d\n"
                                          "Sectors Per Block: %d\nSector Utilization:%d%%\n"
+                                         "GC Blocks:         %d\nGC BG Blocks:      %d\n"
+                                         "GC Max Latency:    %d ms\n"
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                                          "Uneven Wear Count: %d\n"
 #endif
@@ -844,7 +847,9 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                   procfs_data.formatsector, procfs_data.dirsector,
                   procfs_data.freesectors, procfs_data.releasesectors,
                   procfs_data.unusedsectors, procfs_data.blockerases,
-                  procfs_data.sectorsperblk, utilization
+                  procfs_data.sectorsperblk, utilization,
+                  procfs_data.gcblocks, procfs_data.gcbgblocks,
+                  (int)TICK2MSEC(procfs_data.gcmaxticks)
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
 #endif
@@ -1382,6 +1382,7 @@ static int smartfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
   struct                smartfs_chain_header_s *header;
   struct                smart_read_write_s readwrite;
   struct                smartfs_entry_header_s *entry;
+  struct                smartfs_entry_s direntry;
 
   /* Sanity checks */
 
@@ -1460,6 +1461,15 @@ static int smartfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
           memset(dir->fd_dir.d_name, 0, namelen);
           strncpy(dir->fd_dir.d_name, entry->name, namelen);
 
+          /* Save what is needed to return the status of the entry before
+           * the sector buffer is reused.
+           */
+
+          direntry.firstsector = entry->firstsector;
+          direntry.flags       = entry->flags;
+          direntry.utc         = entry->utc;
+          direntry.datlen      = 0;
+
           /* Now advance to the next entry */
 
           dir->u.smartfs.fs_curroffset += entrysize;
@@ -1472,6 +1482,22 @@ static int smartfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
               dir->u.smartfs.fs_currsector = SMARTFS_NEXTSECTOR(header);
             }
 
+          /* Return the status of the entry too, if it was requested.  The
+           * length of a file has to be found from its sector chain.
+           */
+
+          if (dir->fd_stat != NULL)
+            {
+              if ((direntry.flags & SMARTFS_DIRENT_TYPE) ==
+                  SMARTFS_DIRENT_TYPE_FILE)
+                {
+                  (void)smartfs_datlen(fs, direntry.firstsector,
+                                       &direntry.datlen);
+                }
+
+              smartfs_stat_common(fs, &direntry, dir->fd_stat);
+            }
+
           /* Now exit */
 
           ret = OK;
@@ -686,33 +686,8 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
                             {
                               dirsector = entry->firstsector;
 #endif
-                              readwrite.count = sizeof(struct smartfs_chain_header_s);
-                              readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-                              readwrite.offset = 0;
-
-                              while (dirsector != SMARTFS_ERASEDSTATE_16BIT)
-                                {
-                                  /* Read the next sector of the file */
-
-                                  readwrite.logsector = dirsector;
-                                  ret = FS_IOCTL(fs, BIOC_READSECT,
-                                                 (unsigned long) &readwrite);
-                                  if (ret < 0)
-                                    {
-                                      ferr("ERROR: Error in sector chain at %d!\n",
-                                           dirsector);
-                                      break;
-                                    }
-
-                                  /* Add used bytes to the total and point to next sector */
-
-                                  if (*((uint16_t *) header->used) != SMARTFS_ERASEDSTATE_16BIT)
-                                    {
-                                      direntry->datlen += *((uint16_t *) header->used);
-                                    }
-
-                                  dirsector = SMARTFS_NEXTSECTOR(header);
-                                }
+                              (void)smartfs_datlen(fs, dirsector,
+                                                   &direntry->datlen);
                             }
 
                           *parentdirsector = dirstack[depth];
@@ -812,6 +787,56 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smartfs_datlen
+ *
+ * Description: Scan the sector chain of a file beginning at firstsector to
+ *              calculate the length of the file data.  The chain headers
+ *              are read into fs->fs_rwbuffer.
+ *
+ ****************************************************************************/
+
+int smartfs_datlen(struct smartfs_mountpt_s *fs, uint16_t firstsector,
+                   FAR uint32_t *datlen)
+{
+  struct smartfs_chain_header_s *header;
+  struct smart_read_write_s readwrite;
+  uint16_t sector;
+  int ret = OK;
+
+  *datlen = 0;
+  header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
+
+  readwrite.count = sizeof(struct smartfs_chain_header_s);
+  readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+  readwrite.offset = 0;
+
+  sector = firstsector;
+  while (sector != SMARTFS_ERASEDSTATE_16BIT)
+    {
+      /* Read the next sector of the file */
+
+      readwrite.logsector = sector;
+      ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long) &readwrite);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error in sector chain at %d!\n", sector);
+          return ret;
+        }
+
+      /* Add used bytes to the total and point to next sector */
+
+      if (*((uint16_t *) header->used) != SMARTFS_ERASEDSTATE_16BIT)
+        {
+          *datlen += *((uint16_t *) header->used);
+        }
+
+      sector = SMARTFS_NEXTSECTOR(header);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: smartfs_createentry
  *
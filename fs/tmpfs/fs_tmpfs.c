@@ -80,6 +80,14 @@
 #define tmpfs_unlock_directory(tdo) \
            (tmpfs_unlock_object((FAR struct tmpfs_object_s *)tdo))
 
+/* Objects are over-allocated in proportion to their size when they grow so
+ * that a sequence of appends performs only a logarithmic number of
+ * reallocations (and copies) rather than one every ALLOCGUARD bytes.
+ */
+
+#define TMPFS_DIRECTORY_GUARD(s) (CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD + ((s) >> 2))
+#define TMPFS_FILE_GUARD(s)      (CONFIG_FS_TMPFS_FILE_ALLOCGUARD + ((s) >> 2))
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -97,6 +105,11 @@ static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
+static uint16_t tmpfs_hash_name(FAR const char *name);
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -329,7 +342,7 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
    * reallocations.
    */
 
-  objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  objsize += TMPFS_DIRECTORY_GUARD(objsize);
 
   /* Realloc the directory object */
 
@@ -350,6 +363,20 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
   newtdo->tdo_nentries = nentries;
   *tdo                 = newtdo;
 
+  /* The directory entries may have moved.  Reset the backward links from
+   * each of the existing child objects.
+   */
+
+  if (newtdo != oldtdo)
+    {
+      int i;
+
+      for (i = 0; i < ret; i++)
+        {
+          newtdo->tdo_entry[i].tde_object->to_dirent = &newtdo->tdo_entry[i];
+        }
+    }
+
   /* Adjust the reference in the parent directory entry */
 
   DEBUGASSERT(newtdo->tdo_dirent);
@@ -388,11 +415,12 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
       if (newsize > 0)
         {
           /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
+           * lot (more than the amount that would be over-allocated anyway).
            */
 
           delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD +
+                       TMPFS_FILE_GUARD(newsize))
             {
               /* Hasn't shrunk enough.. Return doing nothing for now */
 
@@ -406,7 +434,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
    * reallocations.
    */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  allocsize = objsize + TMPFS_FILE_GUARD(newsize);
 
   /* Realloc the file object */
 
@@ -477,6 +505,71 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     }
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ *
+ * Description:
+ *   Compute the hash of a directory entry name.  The hash is saved in each
+ *   directory entry so that the full string comparison is needed only for
+ *   entries whose hash matches.
+ *
+ ****************************************************************************/
+
+static uint16_t tmpfs_hash_name(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;  /* FNV-1a */
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_add
+ *
+ * Description:
+ *   Add the directory entry at 'index' to its hash bucket.  tde_hash must
+ *   already be set.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+                           unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *bucket = &tdo->tdo_bucket[TMPFS_BUCKET(tde->tde_hash)];
+
+  tde->tde_next = *bucket;
+  *bucket       = index + 1;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_remove
+ *
+ * Description:
+ *   Remove the directory entry at 'index' from its hash bucket.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *link = &tdo->tdo_bucket[TMPFS_BUCKET(tde->tde_hash)];
+
+  while (*link != 0 && *link != index + 1)
+    {
+      link = &tdo->tdo_entry[*link - 1].tde_next;
+    }
+
+  DEBUGASSERT(*link == index + 1);
+  *link = tde->tde_next;
+}
+
 /****************************************************************************
  * Name: tmpfs_find_dirent
  ****************************************************************************/
@@ -484,18 +577,23 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name)
 {
-  int i;
-
-  /* Search the list of directory entries for a match */
+  FAR struct tmpfs_dirent_s *tde;
+  uint16_t hash = tmpfs_hash_name(name);
+  uint16_t next;
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       strcmp(tdo->tdo_entry[i].tde_name, name) != 0;
-       i++);
+  /* Search the entries in the hash bucket for a match */
 
-  /* Return what we found, if anything */
+  for (next = tdo->tdo_bucket[TMPFS_BUCKET(hash)]; next != 0;
+       next = tde->tde_next)
+    {
+      tde = &tdo->tdo_entry[next - 1];
+      if (tde->tde_hash == hash && strcmp(tde->tde_name, name) == 0)
+        {
+          return next - 1;
+        }
+    }
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  return -ENOENT;
 }
 
 /****************************************************************************
@@ -525,6 +623,8 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
 
   /* Remove by replacing this entry with the final directory entry */
 
+  tmpfs_hash_remove(tdo, index);
+
   last = tdo->tdo_nentries - 1;
   if (index != last)
     {
@@ -534,12 +634,17 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
 
       /* Move the directory entry */
 
+      tmpfs_hash_remove(tdo, last);
+
       newtde             = &tdo->tdo_entry[index];
       oldtde             = &tdo->tdo_entry[last];
       to                 = oldtde->tde_object;
 
       newtde->tde_object = to;
       newtde->tde_name   = oldtde->tde_name;
+      newtde->tde_hash   = oldtde->tde_hash;
+
+      tmpfs_hash_add(tdo, index);
 
       /* Reset the backward link to the directory entry */
 
@@ -597,6 +702,9 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
   tde             = &newtdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_hash_name(newname);
+
+  tmpfs_hash_add(newtdo, index);
 
   /* Add backward link to the directory entry to the object */
 
@@ -789,6 +897,7 @@ static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
   tdo->tdo_type     = TMPFS_DIRECTORY;
   tdo->tdo_refs     = 0;
   tdo->tdo_nentries = 0;
+  memset(tdo->tdo_bucket, 0, sizeof(tdo->tdo_bucket));
 
   tdo->tdo_exclsem.ts_holder = TMPFS_NO_HOLDER;
   tdo->tdo_exclsem.ts_count  = 0;
@@ -1227,6 +1336,8 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   to   = tde->tde_object;
   last = tdo->tdo_nentries - 1;
 
+  tmpfs_hash_remove(tdo, index);
+
   if (index != last)
     {
       FAR struct tmpfs_dirent_s *oldtde;
@@ -1234,11 +1345,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
       /* Move the directory entry */
 
+      tmpfs_hash_remove(tdo, last);
+
       oldtde           = &tdo->tdo_entry[last];
       oldto            = oldtde->tde_object;
 
       tde->tde_object  = oldto;
       tde->tde_name    = oldtde->tde_name;
+      tde->tde_hash    = oldtde->tde_hash;
+
+      tmpfs_hash_add(tdo, index);
 
       /* Reset the backward link to the directory entry */
 
@@ -1572,7 +1688,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread  = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1622,6 +1742,8 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   if (endpos > tfo->tfo_size)
     {
+      size_t oldsize = tfo->tfo_size;
+
       /* Reallocate the file to handle the write past the end of the file. */
 
       ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
@@ -1631,6 +1753,15 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
 
       filep->f_priv = tfo;
+
+      /* If the write begins beyond the old end of the file, then the gap
+       * (a "hole") must read as zeros.
+       */
+
+      if (startpos > oldsize)
+        {
+          memset(&tfo->tfo_data[oldsize], 0, startpos - oldsize);
+        }
     }
 
   /* Copy data from the memory object to the user buffer */
@@ -1943,6 +2074,15 @@ static int tmpfs_readdir(FAR struct inode *mountpt,
 
       strncpy(dir->fd_dir.d_name, tde->tde_name, NAME_MAX + 1);
 
+      /* Return the status of the object too, if it was requested */
+
+      if (dir->fd_stat != NULL)
+        {
+          tmpfs_lock_object(to);
+          tmpfs_stat_common(to, dir->fd_stat);
+          tmpfs_unlock_object(to);
+        }
+
       /* Increment the index for next time */
 
       dir->u.tmpfs.tf_index = index + 1;
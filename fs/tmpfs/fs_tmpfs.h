@@ -58,6 +58,19 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Directory hash table */
+
+#ifndef CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS
+#  define CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS 16
+#endif
+
+#if (CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS & \
+     (CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS - 1)) != 0
+#  error CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS must be a power of two
+#endif
+
+#define TMPFS_BUCKET(h)   ((h) & (CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS - 1))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -95,6 +108,8 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint16_t tde_hash;     /* Hash of tde_name (see tmpfs_hash_name()) */
+  uint16_t tde_next;     /* Index + 1 of the next entry in the hash bucket */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -125,6 +140,12 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+
+  /* Hash buckets:  Each holds the index + 1 of the first directory entry
+   * in the bucket or zero if the bucket is empty.
+   */
+
+  uint16_t tdo_bucket[CONFIG_FS_TMPFS_DIRECTORY_NBUCKETS];
   struct tmpfs_dirent_s tdo_entry[1];
 };
 
@@ -39,29 +39,367 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <sys/sendfile.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
+#include <debug.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
-#if CONFIG_NFILE_DESCRIPTORS > 0 && CONFIG_NET_SENDFILE
+#include "inode/inode.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_write
+ *
+ * Description:
+ *   Write all of 'nbytes' of 'buffer' to 'outfile', retrying on partial
+ *   writes.  Returns the number of bytes written which may be less than
+ *   'nbytes' only if an error occurred after some data was transferred.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_write(FAR struct file *outfile,
+                              FAR const uint8_t *buffer, size_t nbytes)
+{
+  ssize_t nwritten;
+  size_t ntotal = 0;
+
+  while (ntotal < nbytes)
+    {
+      nwritten = file_write(outfile, buffer + ntotal, nbytes - ntotal);
+      if (nwritten < 0)
+        {
+          /* file_write() has set the errno value.  EINTR is not an error
+           * if some data has already been transferred (but will still
+           * stop the copy).
+           */
+
+#ifndef CONFIG_DISABLE_SIGNALS
+          if (get_errno() == EINTR && ntotal > 0)
+            {
+              break;
+            }
+#endif
+
+          return ntotal > 0 ? (ssize_t)ntotal : ERROR;
+        }
+
+      ntotal += nwritten;
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: sendfile_mmap
+ *
+ * Description:
+ *   Attempt a zero-copy transfer from a read-only file system that can
+ *   provide the address of the file data in memory (ROMFS on XIP media).
+ *
+ * Returned Value:
+ *   The number of bytes transferred, ERROR on a write failure, or
+ *   -ENOSYS if the input file does not support FIOC_MMAP.  In the latter
+ *   case, neither file has been modified and the caller should fall back
+ *   to a buffered copy.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_mmap(FAR struct file *outfile,
+                             FAR struct file *infile,
+                             FAR off_t *offset, size_t count)
+{
+  FAR struct inode *inode = infile->f_inode;
+  FAR uint8_t *fileaddr;
+  off_t curpos;
+  off_t endpos;
+  off_t pos;
+  ssize_t nwritten;
+  int ret;
+
+  /* Only mountpoint files are candidates.  Character drivers do not
+   * support FIOC_MMAP and might misinterpret the command.
+   *
+   * The file system must also be read-only.  A writable file system such
+   * as tmpfs may reallocate the file data when the file is written or
+   * truncated, possibly by this very transfer if the output is the same
+   * file, and nothing here could prevent that while the data is being
+   * written out.
+   */
+
+  if (inode == NULL || !INODE_IS_MOUNTPT(inode) ||
+      inode->u.i_mops == NULL || inode->u.i_mops->ioctl == NULL ||
+      inode->u.i_mops->write != NULL ||
+      (infile->f_oflags & O_RDOK) == 0)
+    {
+      return -ENOSYS;
+    }
+
+  /* Ask the file system for the address of the file data.  Call the
+   * method directly so that the errno value is not disturbed when the
+   * file system does not support the command.
+   */
+
+  fileaddr = NULL;
+  ret = inode->u.i_mops->ioctl(infile, FIOC_MMAP,
+                               (unsigned long)((uintptr_t)&fileaddr));
+  if (ret < 0 || fileaddr == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  /* Get the size of the file.  The file data is contiguous in memory so
+   * this bounds the transfer.
+   */
+
+  curpos = infile->f_pos;
+  endpos = file_seek(infile, 0, SEEK_END);
+  if (endpos == (off_t)-1 || file_seek(infile, curpos, SEEK_SET) != curpos)
+    {
+      return ERROR;
+    }
+
+  pos = offset != NULL ? *offset : curpos;
+  if (pos < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  if (pos >= endpos)
+    {
+      return 0;
+    }
+
+  if ((off_t)count > endpos - pos)
+    {
+      count = (size_t)(endpos - pos);
+    }
+
+  /* Write directly from the file system memory */
+
+  nwritten = sendfile_write(outfile, fileaddr + pos, count);
+  if (nwritten < 0)
+    {
+      return ERROR;
+    }
+
+  /* Update the file position (or the caller's offset) to reflect the
+   * number of bytes consumed.
+   */
+
+  if (offset != NULL)
+    {
+      *offset = pos + nwritten;
+    }
+  else if (file_seek(infile, pos + nwritten, SEEK_SET) == (off_t)-1)
+    {
+      return ERROR;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: sendfile_copy
+ *
+ * Description:
+ *   Transfer the data using a kernel I/O buffer.  This works with any
+ *   readable source, including drivers and file systems that have no
+ *   memory-resident representation of the file data.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_copy(FAR struct file *outfile,
+                             FAR struct file *infile,
+                             FAR off_t *offset, size_t count)
+{
+  FAR uint8_t *iobuffer;
+  off_t startpos = 0;
+  ssize_t nread;
+  ssize_t nwritten;
+  ssize_t ntransferred;
+  int errcode = 0;
+
+  /* If an offset was provided, position the input file at that offset
+   * now and restore the original position when the transfer completes.
+   */
+
+  if (offset != NULL)
+    {
+      startpos = file_seek(infile, 0, SEEK_CUR);
+      if (startpos == (off_t)-1 ||
+          file_seek(infile, *offset, SEEK_SET) == (off_t)-1)
+        {
+          return ERROR;
+        }
+    }
+
+  /* Allocate an I/O buffer from the kernel heap */
+
+  iobuffer = (FAR uint8_t *)kmm_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
+  if (iobuffer == NULL)
+    {
+      errcode = ENOMEM;
+      ntransferred = ERROR;
+      goto errout_with_seek;
+    }
+
+  /* Now transfer 'count' bytes from the infile to the outfile */
+
+  for (ntransferred = 0; ntransferred < (ssize_t)count; )
+    {
+      size_t nbytes = count - ntransferred;
+
+      if (nbytes > CONFIG_LIB_SENDFILE_BUFSIZE)
+        {
+          nbytes = CONFIG_LIB_SENDFILE_BUFSIZE;
+        }
+
+      nread = file_read(infile, iobuffer, nbytes);
+      if (nread == 0)
+        {
+          /* End of file */
+
+          break;
+        }
+      else if (nread < 0)
+        {
+          /* Read error.  EINTR will stop the copy but is not an error if
+           * some data has already been transferred.
+           */
+
+          errcode = get_errno();
+#ifndef CONFIG_DISABLE_SIGNALS
+          if (errcode != EINTR || ntransferred == 0)
+#endif
+            {
+              ntransferred = ERROR;
+            }
+
+          break;
+        }
+
+      nwritten = sendfile_write(outfile, iobuffer, nread);
+      if (nwritten < 0)
+        {
+          errcode = get_errno();
+          if (ntransferred == 0)
+            {
+              ntransferred = ERROR;
+            }
+
+          nwritten = 0;
+        }
+      else
+        {
+          ntransferred += nwritten;
+        }
+
+      if (nwritten < nread)
+        {
+          /* The write failed or was interrupted.  Back up over the data
+           * that was read but not written so that the file position (or
+           * the returned offset) is accurate.  This fails harmlessly if
+           * the source is not seekable.
+           */
+
+          (void)file_seek(infile, nwritten - nread, SEEK_CUR);
+          break;
+        }
+    }
+
+  kmm_free(iobuffer);
+
+errout_with_seek:
+  if (offset != NULL)
+    {
+      off_t curpos = file_seek(infile, 0, SEEK_CUR);
+
+      if (curpos != (off_t)-1)
+        {
+          *offset = curpos;
+        }
+
+      (void)file_seek(infile, startpos, SEEK_SET);
+    }
+
+  if (ntransferred < 0)
+    {
+      set_errno(errcode);
+    }
+
+  return ntransferred;
+}
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: file_sendfile
+ *
+ * Description:
+ *   Equivalent to the standard sendfile() function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ * Returned Value:
+ *   The number of bytes written to outfile on success.  On failure, -1
+ *   (ERROR) is returned and the errno value is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
+                      FAR off_t *offset, size_t count)
+{
+  ssize_t ret;
+
+  DEBUGASSERT(outfile != NULL && infile != NULL);
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  /* Try the zero-copy path first */
+
+  ret = sendfile_mmap(outfile, infile, offset, count);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
+  /* Fall back to copying through a kernel I/O buffer */
+
+  return sendfile_copy(outfile, infile, offset, count);
+}
+
 /****************************************************************************
  * Name: sendfile
  *
  * Description:
  *   sendfile() copies data between one file descriptor and another.
- *   Used with file descriptors it basically just wraps a sequence of
- *   reads() and writes() to perform a copy.
+ *
+ *   If both descriptors are file descriptors, the data is moved entirely
+ *   within the kernel by file_sendfile() (without any user-space copies and,
+ *   when the source file data is memory-resident, without any intermediate
+ *   copy at all).  This includes transfers into pipes and FIFOs.
  *
  *   If the destination descriptor is a socket, it gives a better
  *   performance than simple reds() and writes(). The data is read directly
@@ -102,42 +440,54 @@
 
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 {
-#if defined(CONFIG_NET_TCP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  FAR struct file *infile;
+  FAR struct file *outfile;
 
-  /* Check the destination file descriptor:  Is it a (probable) file
-   * descriptor?  Check the source file:  Is it a normal file?
-   */
+  /* Check the source file:  Is it a normal file? */
 
-  if ((unsigned int)outfd >= CONFIG_NFILE_DESCRIPTORS &&
-      (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS)
+  if ((unsigned int)infd < CONFIG_NFILE_DESCRIPTORS)
     {
-      FAR struct file *filep;
-
-      /* This appears to be a file-to-socket transfer.  Get the file
-       * structure.
-       */
+      /* Get the source file structure */
 
-      filep = fs_getfilep(fd);
-      if (!filep)
+      infile = fs_getfilep(infd);
+      if (infile == NULL)
         {
           /* The errno value has already been set */
 
           return ERROR;
         }
 
-      /* Then let net_sendfile do the work. */
+      /* Check the destination:  Is it also a file descriptor? */
 
-      return net_sendfile(outfd, filep, offset, count);
-    }
-  else
-#endif
-    {
-      /* No... then this is probably a file-to-file transfer.  The generic
-       * lib_sendfile() can handle that case.
+      if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS)
+        {
+          /* This is a file-to-file transfer (which includes pipes and
+           * character drivers).  Let file_sendfile() do the work.
+           */
+
+          outfile = fs_getfilep(outfd);
+          if (outfile == NULL)
+            {
+              return ERROR;
+            }
+
+          return file_sendfile(outfile, infile, offset, count);
+        }
+
+#if defined(CONFIG_NET_SENDFILE) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      /* No.. then this appears to be a file-to-socket transfer.  Let
+       * net_sendfile do the work.
        */
 
-      return lib_sendfile(outfd, infd, offset, count);
+      return net_sendfile(outfd, infile, offset, count);
+#endif
     }
+
+  /* The source is a socket.  The generic lib_sendfile() can handle that
+   * case.
+   */
+
+  return lib_sendfile(outfd, infd, offset, count);
 }
 
-#endif /* CONFIG_NFILE_DESCRIPTORS > 0 && CONFIG_NET_SENDFILE */
+#endif /* CONFIG_NFILE_DESCRIPTORS > 0 */
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <limits.h>
 
@@ -83,6 +84,17 @@ struct dirent
   char      d_name[NAME_MAX+1]; /* filename */
 };
 
+/* One entry returned by the non-standard readdirstat() interface:  The
+ * directory entry together with the information that stat() would return
+ * for it.
+ */
+
+struct direntstat
+{
+  struct dirent ds_dirent;      /* The directory entry */
+  struct stat   ds_stat;        /* Status of the entry */
+};
+
 typedef void DIR;
 
 /****************************************************************************
@@ -113,6 +125,11 @@ void       rewinddir(FAR DIR *dirp);
 void       seekdir(FAR DIR *dirp, off_t loc);
 off_t      telldir(FAR DIR *dirp);
 
+/* Non-standard interfaces */
+
+int        readdirstat(FAR DIR *dirp, FAR struct direntstat *entries,
+                       int nentries);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -150,7 +150,9 @@ struct rwbuffer_s
   sem_t         rhsem;           /* Enforces exclusive access to the write buffer */
   uint8_t      *rhbuffer;        /* Allocated read-ahead buffer */
   uint16_t      rhnblocks;       /* Number of blocks in read-ahead buffer */
+  uint16_t      rhwindow;        /* Current read-ahead window in blocks */
   off_t         rhblockstart;    /* First block in read-ahead buffer */
+  off_t         rhseqblock;      /* Block following the last read request */
 #endif
 };
 
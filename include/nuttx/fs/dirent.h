@@ -212,6 +212,13 @@ struct fs_dirent_s
 
   off_t fd_position;
 
+  /* If non-NULL, the file system may also return the status of the entry
+   * here when readdir() is called.  The file system sets st_mode only if
+   * it does so.  This is used by readdirstat().
+   */
+
+  FAR struct stat *fd_stat;
+
   /* Retained control information depends on the type of file system that
    * provides is provides the mountpoint.  Ideally this information should
    * be hidden behind an opaque, file-system-dependent void *, but we put
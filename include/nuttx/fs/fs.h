@@ -372,6 +372,7 @@ struct file
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
+  int     fl_minfree;           /* All descriptors below this are in use */
   struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
 };
 #endif
@@ -828,7 +829,7 @@ int lib_flushall(FAR struct streamlist *list);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#if CONFIG_NFILE_DESCRIPTORS > 0
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count);
 #endif
 
@@ -926,6 +927,29 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 off_t file_seek(FAR struct file *filep, off_t offset, int whence);
 #endif
 
+/****************************************************************************
+ * Name: file_sendfile
+ *
+ * Description:
+ *   Equivalent to the standard sendfile() function except that is accepts
+ *   struct file instances instead of file descriptors.  The data is moved
+ *   entirely within the kernel:  If the source is on a read-only file
+ *   system that can provide the address of the file data (FIOC_MMAP, as
+ *   with ROMFS on XIP media), then the data is written directly from the
+ *   file system memory with no intermediate copy.  Otherwise, a kernel I/O
+ *   buffer is used.
+ *
+ * Returned Value:
+ *   The number of bytes written to outfile on success.  On failure, -1
+ *   (ERROR) is returned and the errno value is set appropriately.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
+                      FAR off_t *offset, size_t count);
+#endif
+
 /****************************************************************************
  * Name: file_fsync
  *
@@ -333,6 +333,14 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0002)  /* Get ring buffer size
+                                             * IN: Pointer to int
+                                             * OUT: Size in bytes */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0003)  /* Resize ring buffer
+                                             * IN: unsigned long integer
+                                             *     new size in bytes (at
+                                             *     most DEV_PIPE_MAXSIZE)
+                                             * OUT: None */
 
 /* RTC driver ioctl definitions *********************************************/
 /* (see nuttx/include/rtc.h */
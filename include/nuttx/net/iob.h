@@ -88,6 +88,20 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* The elastic pool may grow from CONFIG_IOB_NBUFFERS up to
+ * CONFIG_IOB_MAXBUFFERS I/O buffers.
+ */
+
+#ifdef CONFIG_IOB_ELASTIC
+#  if !defined(CONFIG_IOB_MAXBUFFERS) || \
+      CONFIG_IOB_MAXBUFFERS <= CONFIG_IOB_NBUFFERS + CONFIG_IOB_THROTTLE
+#    error CONFIG_IOB_MAXBUFFERS <= CONFIG_IOB_NBUFFERS + CONFIG_IOB_THROTTLE
+#  endif
+#else
+#  undef CONFIG_IOB_MAXBUFFERS
+#  define CONFIG_IOB_MAXBUFFERS CONFIG_IOB_NBUFFERS
+#endif
+
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
@@ -156,6 +170,23 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+#ifdef CONFIG_IOB_STATISTICS
+/* I/O buffer usage statistics */
+
+struct iob_stats_s
+{
+  uint16_t nbuffers;    /* Number of I/O buffers in the pool */
+  uint16_t nfree;       /* Number of free I/O buffers */
+  uint16_t ninuse;      /* Number of I/O buffers in use */
+  uint16_t maxinuse;    /* Largest number of I/O buffers ever in use */
+  uint32_t nfailed;     /* Allocations that found no free I/O buffer */
+#ifdef CONFIG_IOB_ELASTIC
+  uint32_t ngrow;       /* I/O buffers allocated from the heap */
+  uint32_t nshrink;     /* I/O buffers returned to the heap */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -184,6 +215,19 @@ void iob_initialize(void);
 
 FAR struct iob_s *iob_alloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc
+ *
+ * Description:
+ *   Try to allocate an I/O buffer by taking the buffer at the head of the
+ *   free list without waiting for a buffer to become free.  If the free
+ *   list is empty and this is not an interrupt handler, the elastic pool
+ *   is grown from the heap instead.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc(bool throttled);
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -278,6 +322,19 @@ FAR struct iob_s *iob_peek_queue(FAR struct iob_queue_s *iobq);
 void iob_free_queue(FAR struct iob_queue_s *qhead);
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+/****************************************************************************
+ * Name: iob_count_queue
+ *
+ * Description:
+ *   Return the number of I/O buffers held by all of the I/O buffer chains
+ *   in a queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+unsigned int iob_count_queue(FAR struct iob_queue_s *iobq);
+#endif
+
 /****************************************************************************
  * Name: iob_copyin
  *
@@ -402,6 +459,18 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob);
 
 int iob_contig(FAR struct iob_s *iob, unsigned int len);
 
+/****************************************************************************
+ * Name: iob_stats
+ *
+ * Description:
+ *   Return a snapshot of the I/O buffer usage statistics.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_STATISTICS
+void iob_stats(FAR struct iob_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Function: iob_dump
  *
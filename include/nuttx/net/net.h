@@ -138,6 +138,12 @@ struct socketlist
 struct net_driver_s; /* Forward reference. Defined in nuttx/net/netdev.h */
 typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev, FAR void *arg);
 
+/* Called when the data passed to send_zerocopy() is no longer referenced.
+ * result is OK if all of the data was ACKed.
+ */
+
+typedef CODE void (*send_zcnotify_t)(FAR void *arg, int result);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -208,6 +214,12 @@ void net_initialize(void);
  *   net_lockedwait()    - Like pthread_cond_wait(); releases the semaphore
  *                         momentarily to wait on another semaphore()
  *
+ * Drivers that keep a per-device lock should copy packet data under that
+ * lock alone and take the network lock only around calls into the stack.
+ * A device lock is always taken before the network lock, never while
+ * holding it.  Since d_txavail() is called with the network locked, it
+ * must not take the device lock; it should defer the poll to a work queue.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -693,6 +705,40 @@ int psock_connect(FAR struct socket *psock, FAR const struct sockaddr *addr,
 ssize_t psock_send(FAR struct socket *psock, const void *buf, size_t len,
                    int flags);
 
+/****************************************************************************
+ * Function: send_zerocopy
+ *
+ * Description:
+ *   Send data on a connected TCP socket without copying it into the write
+ *   buffers:  The queued data refers to the caller's buffer, which must
+ *   not be modified or freed until notify is called.  notify is called
+ *   with OK when all of the data has been ACKed, or with a negated errno
+ *   value if the data was discarded because the connection was lost.  It
+ *   is called from the network stack with the network locked and must not
+ *   block.
+ *
+ *   No more than UINT16_MAX bytes are queued by one call.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   notify   Called when the data is no longer referenced
+ *   arg      Argument passed to notify
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  notify will be called
+ *   exactly once for those bytes.  On error, -1 is returned, errno is set
+ *   as for send(), and notify will not be called.  EOPNOTSUPP is reported
+ *   for sockets other than TCP sockets.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+ssize_t send_zerocopy(int sockfd, FAR const void *buf, size_t len,
+                      send_zcnotify_t notify, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Function: psock_sendto
  *
@@ -825,6 +871,45 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Function: psock_recvfrom_iob and recvfrom_iob
+ *
+ * Description:
+ *   Receive data from a TCP or UDP socket without copying it:  The I/O
+ *   buffer chain holding the data is removed from the socket's read-ahead
+ *   buffers and returned to the caller, who must release it with
+ *   iob_free_chain() when the data has been consumed.
+ *
+ *   For a TCP socket, the chain holds the data of one or more received
+ *   segments.  For a UDP socket, it holds exactly one datagram and, if
+ *   from is not NULL, the sender's address is returned as by recvfrom().
+ *   from is not used with TCP sockets.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   sockfd   Socket descriptor of socket
+ *   iobp     The location to return the I/O buffer chain
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned I/O buffer
+ *   chain.  Zero is returned with *iobp set to NULL if the TCP peer has
+ *   performed an orderly shutdown.  Otherwise, on errors, -1 is returned,
+ *   and errno is set as for recvfrom().  EOPNOTSUPP is reported for a
+ *   socket type without read-ahead buffering.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+struct iob_s;  /* Forward reference */
+ssize_t psock_recvfrom_iob(FAR struct socket *psock, FAR struct iob_s **iobp,
+                           FAR struct sockaddr *from,
+                           FAR socklen_t *fromlen);
+ssize_t recvfrom_iob(int sockfd, FAR struct iob_s **iobp,
+                     FAR struct sockaddr *from, FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Function: psock_getsockopt
  *
@@ -519,6 +519,33 @@ void neighbor_out(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * I/O buffer packet interface
+ *
+ * A driver that holds frames in I/O buffer chains may pass a whole batch of
+ * received frames to netdev_iob_input().  Each frame is copied into d_buf
+ * and handed to the driver's 'rxframe' function, which dispatches it just as
+ * if it had been received directly into d_buf.
+ *
+ * netdev_iob_output() copies the outgoing packet in d_buf into a new I/O
+ * buffer chain so that the driver may queue it and later transmit it by
+ * gathering the data from each buffer of the chain.
+ *
+ * Both must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB
+struct iob_s;        /* Forward reference */
+struct iob_queue_s;  /* Forward reference */
+
+typedef CODE void (*netdev_rxframe_t)(FAR struct net_driver_s *dev);
+
+int netdev_iob_input(FAR struct net_driver_s *dev,
+                     FAR struct iob_queue_s *rxq, netdev_rxframe_t rxframe);
+FAR struct iob_s *netdev_iob_output(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -76,8 +76,17 @@
 #define TCP_OPT_END       0   /* End of TCP options list */
 #define TCP_OPT_NOOP      1   /* "No-operation" TCP option */
 #define TCP_OPT_MSS       2   /* Maximum segment size TCP option */
+#define TCP_OPT_WS        3   /* Window scale TCP option (RFC 7323) */
+#define TCP_OPT_SACK_PERM 4   /* SACK permitted TCP option (RFC 2018) */
+#define TCP_OPT_SACK      5   /* SACK TCP option (RFC 2018) */
 
 #define TCP_OPT_MSS_LEN   4   /* Length of TCP MSS option. */
+#define TCP_OPT_WS_LEN    3   /* Length of TCP window scale option */
+#define TCP_OPT_SACK_PERM_LEN 2 /* Length of TCP SACK permitted option */
+#define TCP_OPT_SACK_BLKLEN 8 /* Length of one block in the SACK option */
+
+#define TCP_MAX_WSCALE    14  /* Maximum window scale shift (RFC 7323) */
+#define TCP_MAX_SACKBLKS  4   /* Maximum number of SACK blocks in a segment */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -173,6 +182,10 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                              available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  net_stats_t ooseq;      /* Number of out-of-order segments retained */
+  net_stats_t oodrop;     /* Number of out-of-order segments discarded */
+#endif
 };
 #endif
 
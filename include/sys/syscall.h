@@ -355,12 +355,9 @@
 #    define __SYS_sendfile             (__SYS_fs_fdopen+0)
 #  endif
 
-#  if defined(CONFIG_NET_SENDFILE)
-#    define SYS_sendfile,              __SYS_sendfile
-#    define __SYS_mountpoint           (__SYS_sendfile+1)
-#  else
-#    define __SYS_mountpoint           __SYS_sendfile
-#  endif
+#    define SYS_sendfile               (__SYS_sendfile+0)
+#    define SYS_readdirstat            (__SYS_sendfile+1)
+#    define __SYS_mountpoint           (__SYS_sendfile+2)
 
 #  if !defined(CONFIG_DISABLE_MOUNTPOINT)
 #  if defined(CONFIG_FS_READABLE)
@@ -59,7 +59,7 @@
 struct lio_sighand_s
 {
   FAR struct aiocb * const *list;  /* List of I/O operations */
-  FAR struct sigevent *sig;        /* Describes how to signal the caller */
+  struct sigevent sig;             /* Describes how to signal the caller */
   int nent;                        /* Number or elements in list[] */
   pid_t pid;                       /* ID of client */
   sigset_t oprocmask;              /* sigprocmask to restore */
@@ -191,23 +191,25 @@ static void lio_sighandler(int signo, siginfo_t *info, void *ucontext)
 
       /* Signal the client */
 
-      if (sighand->sig->sigev_notify == SIGEV_SIGNAL)
+      if (sighand->sig.sigev_notify == SIGEV_SIGNAL)
         {
 #ifdef CONFIG_CAN_PASS_STRUCTS
-          DEBUGASSERT(sigqueue(sighand->pid, sighand->sig->sigev_signo,
-                               sighand->sig->sigev_value));
+          ret = sigqueue(sighand->pid, sighand->sig.sigev_signo,
+                         sighand->sig.sigev_value);
 #else
-          DEBUGASSERT(sigqueue(sighand->pid, sighand->sig->sigev_signo,
-                               sighand->sig->sigev_value.sival_ptr));
+          ret = sigqueue(sighand->pid, sighand->sig.sigev_signo,
+                         sighand->sig.sigev_value.sival_ptr);
 #endif
+          DEBUGASSERT(ret == OK);
         }
 
 #ifdef CONFIG_SIG_EVTHREAD
       /* Notify the client via a function call */
 
-      else if (ighand->sig->sigev_notify == SIGEV_THREAD)
+      else if (sighand->sig.sigev_notify == SIGEV_THREAD)
         {
-          DEBUGASSERT(sig_notification(sighand->pid, &sighand->sig));
+          ret = sig_notification(sighand->pid, &sighand->sig);
+          DEBUGASSERT(ret == OK);
         }
 #endif
 
@@ -219,6 +221,33 @@ static void lio_sighandler(int signo, siginfo_t *info, void *ucontext)
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: lio_sigrelease
+ *
+ * Description:
+ *   Undo the partial setup performed by lio_sigsetup() on a failure:  Detach
+ *   the signal handler data from each AIO control block and free it.
+ *
+ ****************************************************************************/
+
+static void lio_sigrelease(FAR struct aiocb * const *list, int nent,
+                           FAR struct lio_sighand_s *sighand)
+{
+  FAR struct aiocb *aiocbp;
+  int i;
+
+  for (i = 0; i < nent; i++)
+    {
+      aiocbp = list[i];
+      if (aiocbp && aiocbp->aio_priv == (FAR void *)sighand)
+        {
+          aiocbp->aio_priv = NULL;
+        }
+    }
+
+  lib_free(sighand);
+}
+
 /****************************************************************************
  * Name: lio_sigsetup
  *
@@ -262,7 +291,7 @@ static int lio_sigsetup(FAR struct aiocb * const *list, int nent,
   /* Initialize the allocated structure */
 
   sighand->list = list;
-  sighand->sig  = sig;
+  sighand->sig  = *sig;
   sighand->nent = nent;
   sighand->pid  = getpid();
 
@@ -298,12 +327,12 @@ static int lio_sigsetup(FAR struct aiocb * const *list, int nent,
       int errcode = get_errno();
       ferr("ERROR sigprocmask failed: %d\n", errcode);
       DEBUGASSERT(errcode > 0);
+      lio_sigrelease(list, nent, sighand);
       return -errcode;
     }
 
   /* Attach our signal handler */
 
-  printf("waiter_main: Registering signal handler\n");
   act.sa_sigaction = lio_sighandler;
   act.sa_flags = SA_SIGINFO;
 
@@ -316,6 +345,8 @@ static int lio_sigsetup(FAR struct aiocb * const *list, int nent,
       int errcode = get_errno();
       ferr("ERROR sigaction failed: %d\n", errcode);
       DEBUGASSERT(errcode > 0);
+      (void)sigprocmask(SIG_SETMASK, &sighand->oprocmask, NULL);
+      lio_sigrelease(list, nent, sighand);
       return -errcode;
     }
 
@@ -670,7 +701,11 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
    *   caller ourself?
    */
 
-  else if (sig && sig->sigev_notify == SIGEV_SIGNAL)
+  else if (sig && (sig->sigev_notify == SIGEV_SIGNAL
+#ifdef CONFIG_SIG_EVTHREAD
+                   || sig->sigev_notify == SIGEV_THREAD
+#endif
+                  ))
     {
       if (nqueued > 0)
         {
@@ -687,6 +722,23 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
               ret     = ERROR;
             }
         }
+#ifdef CONFIG_SIG_EVTHREAD
+      /* Notify the client via a function call */
+
+      else if (sig->sigev_notify == SIGEV_THREAD)
+        {
+          status = sig_notification(getpid(), sig);
+          if (status < 0 && ret == OK)
+            {
+              /* Something bad happened while performing the notification
+               * and this is the first error to be reported.
+               */
+
+              retcode = -status;
+              ret     = ERROR;
+            }
+        }
+#endif
       else
         {
 #ifdef CONFIG_CAN_PASS_STRUCTS
@@ -708,24 +760,6 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
         }
     }
 
-#ifdef CONFIG_SIG_EVTHREAD
-  /* Notify the client via a function call */
-
-  else if (sig && sig->sigev_notify == SIGEV_THREAD)
-    {
-      status = sig_notification(sighand->pid, &sighand->sig);
-      if (status < 0 && ret == OK)
-        {
-         /* Something bad happened while performing the notification
-          * and this is the first error to be reported.
-          */
-
-          retcode = -status;
-          ret     = ERROR;
-        }
-    }
-#endif
-
   /* Case 3: mode == LIO_NOWAIT and sig == NULL
    *
    *   Just return now.
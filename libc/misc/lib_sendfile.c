@@ -113,7 +113,7 @@
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_SENDFILE
+#if CONFIG_NFILE_DESCRIPTORS > 0
 ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count)
 #else
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
@@ -229,9 +229,17 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
 
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  /* Traverse only the TCP connections that have callbacks waiting for the
+   * poll action.
+   */
+
+  while (!bstop && (conn = tcp_nextpending(conn)))
+#else
   /* Traverse all of the active TCP connections and perform the poll action */
 
   while (!bstop && (conn = tcp_nextconn(conn)))
+#endif
     {
       /* Perform the TCP TX poll */
 
@@ -48,10 +48,59 @@
 
 #ifdef CONFIG_NET_IOB
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if the I/O buffer was allocated from the heap */
+
+#ifdef CONFIG_IOB_ELASTIC
+#  define IOB_ISDYNAMIC(p) \
+     ((p) < &g_iob_pool[0] || (p) >= &g_iob_pool[CONFIG_IOB_NBUFFERS])
+#endif
+
+/* Statistics */
+
+#ifdef CONFIG_IOB_STATISTICS
+#  define IOB_STATS_ALLOC() \
+     do \
+       { \
+         if (++g_iob_stats.ninuse > g_iob_stats.maxinuse) \
+           { \
+             g_iob_stats.maxinuse = g_iob_stats.ninuse; \
+           } \
+       } \
+     while (0)
+#  define IOB_STATS_FREE()  (g_iob_stats.ninuse--)
+#  define IOB_STATS(f)      (g_iob_stats.f++)
+#else
+#  define IOB_STATS_ALLOC()
+#  define IOB_STATS_FREE()
+#  define IOB_STATS(f)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+/* The pool of pre-allocated I/O buffers */
+
+extern struct iob_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+
+#ifdef CONFIG_IOB_ELASTIC
+/* The number of I/O buffers currently allocated from the heap */
+
+extern uint16_t g_iob_ndynamic;
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+/* Usage statistics.  Only the counters are maintained here; the pool size
+ * and free count are computed by iob_stats().
+ */
+
+extern struct iob_stats_s g_iob_stats;
+#endif
+
 /* A list of all free, unallocated I/O buffers */
 
 extern FAR struct iob_s *g_iob_freelist;
@@ -100,17 +149,6 @@ FAR struct iob_qentry_s *iob_alloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
-/****************************************************************************
- * Name: iob_tryalloc
- *
- * Description:
- *   Try to allocate an I/O buffer by taking the buffer at the head of the
- *   free list without waiting for a buffer to become free.
- *
- ****************************************************************************/
-
-FAR struct iob_s *iob_tryalloc(bool throttled);
-
 /****************************************************************************
  * Name: iob_free_qentry
  *
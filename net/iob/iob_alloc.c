@@ -49,9 +49,11 @@
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
+#include <debug.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/iob.h>
 
 #include "iob.h"
@@ -60,6 +62,76 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_grow
+ *
+ * Description:
+ *   Allocate a new I/O buffer from the heap if the pool has not yet reached
+ *   its maximum size.  Throttled allocations may not grow the pool into the
+ *   last CONFIG_IOB_THROTTLE buffers.  This function cannot be called from
+ *   any interrupt level logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ELASTIC
+static FAR struct iob_s *iob_grow(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  unsigned int limit;
+
+  limit = CONFIG_IOB_MAXBUFFERS - CONFIG_IOB_NBUFFERS;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      limit = (limit > CONFIG_IOB_THROTTLE) ? limit - CONFIG_IOB_THROTTLE : 0;
+    }
+#endif
+
+  /* Reserve the buffer before allocating it:  kmm_malloc() may block and
+   * let another thread in.
+   */
+
+  flags = enter_critical_section();
+  if (g_iob_ndynamic >= limit)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+  g_iob_ndynamic++;
+  leave_critical_section(flags);
+
+  iob = (FAR struct iob_s *)kmm_malloc(sizeof(struct iob_s));
+  if (iob == NULL)
+    {
+      flags = enter_critical_section();
+      g_iob_ndynamic--;
+      leave_critical_section(flags);
+      return NULL;
+    }
+
+#ifdef CONFIG_IOB_STATISTICS
+  /* The counters are also updated by iob_free() from interrupt handlers */
+
+  flags = enter_critical_section();
+  IOB_STATS(ngrow);
+  IOB_STATS_ALLOC();
+  leave_critical_section(flags);
+#endif
+
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL;
+  iob->io_len    = 0;
+  iob->io_offset = 0;
+  iob->io_pktlen = 0;
+
+  ninfo("Grew pool: iob=%p ndynamic=%u\n", iob, g_iob_ndynamic);
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -198,7 +270,9 @@ FAR struct iob_s *iob_alloc(bool throttled)
  *
  * Description:
  *   Try to allocate an I/O buffer by taking the buffer at the head of the
- *   free list without waiting for a buffer to become free.
+ *   free list without waiting for a buffer to become free.  If the free
+ *   list is empty and this is not an interrupt handler, the elastic pool
+ *   is grown from the heap instead.
  *
  ****************************************************************************/
 
@@ -258,6 +332,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
           g_throttle_sem.semcount--;
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
+          IOB_STATS_ALLOC();
           leave_critical_section(flags);
 
           /* Put the I/O buffer in a known state */
@@ -271,5 +346,27 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
     }
 
   leave_critical_section(flags);
+
+#ifdef CONFIG_IOB_ELASTIC
+  /* There are no free buffers.  Try to add one to the pool unless we were
+   * called from an interrupt handler.
+   */
+
+  if (!up_interrupt_context())
+    {
+      iob = iob_grow(throttled);
+      if (iob != NULL)
+        {
+          return iob;
+        }
+    }
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+  flags = enter_critical_section();
+  IOB_STATS(nfailed);
+  leave_critical_section(flags);
+#endif
+
   return NULL;
 }
@@ -52,6 +52,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/iob.h>
 
 #include "iob.h"
@@ -114,6 +115,33 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
    */
 
   flags = enter_critical_section();
+  IOB_STATS_FREE();
+
+#ifdef CONFIG_IOB_ELASTIC
+  /* A buffer that was allocated from the heap is returned to the heap,
+   * shrinking the pool, unless some allocation is waiting for a buffer.
+   * A negative throttle count may also just mean that read-ahead is being
+   * throttled; keeping the buffer in the pool is correct in that case too.
+   */
+
+  if (IOB_ISDYNAMIC(iob) && g_iob_sem.semcount >= 0
+#if CONFIG_IOB_THROTTLE > 0
+      && g_throttle_sem.semcount >= 0
+#endif
+     )
+    {
+      DEBUGASSERT(g_iob_ndynamic > 0);
+      g_iob_ndynamic--;
+      IOB_STATS(nshrink);
+      leave_critical_section(flags);
+
+      /* sched_kfree() defers the free if we are in an interrupt handler */
+
+      sched_kfree(iob);
+      return next;
+    }
+#endif
+
   iob->io_flink = g_iob_freelist;
   g_iob_freelist = iob;
 
@@ -57,9 +57,8 @@
  * Private Data
  ****************************************************************************/
 
-/* This is a pool of pre-allocated I/O buffers */
+/* This is a pool of pre-allocated I/O buffer chain containers */
 
-static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -68,6 +67,22 @@ static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
  * Public Data
  ****************************************************************************/
 
+/* This is a pool of pre-allocated I/O buffers */
+
+struct iob_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+
+#ifdef CONFIG_IOB_ELASTIC
+/* The number of I/O buffers currently allocated from the heap */
+
+uint16_t g_iob_ndynamic;
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+/* Usage statistics */
+
+struct iob_stats_s g_iob_stats;
+#endif
+
 /* A list of all free, unallocated I/O buffers */
 
 FAR struct iob_s *g_iob_freelist;
@@ -0,0 +1,83 @@
+/****************************************************************************
+ * net/iob/iob_stats.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <semaphore.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_STATISTICS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_stats
+ *
+ * Description:
+ *   Return a snapshot of the I/O buffer usage statistics.
+ *
+ ****************************************************************************/
+
+void iob_stats(FAR struct iob_stats_s *stats)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  *stats = g_iob_stats;
+
+  /* The free count is the count of the semaphore; a negative count means
+   * that there are no free buffers and some allocations are waiting.
+   */
+
+  stats->nfree    = g_iob_sem.semcount > 0 ? g_iob_sem.semcount : 0;
+#ifdef CONFIG_IOB_ELASTIC
+  stats->nbuffers = CONFIG_IOB_NBUFFERS + g_iob_ndynamic;
+#else
+  stats->nbuffers = CONFIG_IOB_NBUFFERS;
+#endif
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_IOB_STATISTICS */
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * net/netdev/netdev_iob.c
+ * I/O buffer packet interface for network drivers
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NETDEV_IOB)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS < 1
+#  error CONFIG_NETDEV_IOB requires CONFIG_IOB_NCHAINS > 0
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_iob_input
+ *
+ * Description:
+ *   Process a batch of received frames held in I/O buffer chains.  Each
+ *   frame is removed from the queue and copied into d_buf, then the
+ *   driver's 'rxframe' function is called to pass the frame to the
+ *   network just as if it had been received directly into d_buf.  The I/O
+ *   buffer chains are freed.
+ *
+ *   'rxframe' may add new frames to the queue; these are processed before
+ *   this function returns.
+ *
+ * Parameters:
+ *   dev     - The device driver structure
+ *   rxq     - The queue of received frames
+ *   rxframe - The driver function that dispatches the frame in d_buf
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int netdev_iob_input(FAR struct net_driver_s *dev,
+                     FAR struct iob_queue_s *rxq, netdev_rxframe_t rxframe)
+{
+  FAR struct iob_s *iob;
+  unsigned int maxlen;
+  int nframes = 0;
+
+  /* The MTU includes the link layer header */
+
+  maxlen = NET_DEV_MTU(dev);
+
+  while ((iob = iob_remove_queue(rxq)) != NULL)
+    {
+      /* Frames that will not fit in the device buffer are dropped */
+
+      if (iob->io_pktlen > maxlen)
+        {
+          nwarn("WARNING: Dropped frame, len=%u\n", iob->io_pktlen);
+          NETDEV_RXDROPPED(dev);
+        }
+      else
+        {
+          dev->d_len = iob_copyout(dev->d_buf, iob, iob->io_pktlen, 0);
+          rxframe(dev);
+        }
+
+      iob_free_chain(iob);
+      nframes++;
+    }
+
+  return nframes;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_output
+ *
+ * Description:
+ *   Copy the outgoing packet in d_buf into a new I/O buffer chain.  The
+ *   driver may then queue the chain and transmit it later by gathering the
+ *   data from each I/O buffer of the chain.  d_len is not modified.
+ *
+ * Parameters:
+ *   dev - The device driver structure
+ *
+ * Returned Value:
+ *   The new I/O buffer chain.  NULL is returned if there is no packet in
+ *   d_buf or if there are not enough free I/O buffers to hold it; the
+ *   driver should then transmit the packet directly from d_buf.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *netdev_iob_output(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob;
+  int ret;
+
+  if (dev->d_len == 0)
+    {
+      return NULL;
+    }
+
+  /* Allocate without waiting:  The caller is a driver that cannot block.
+   * The allocation is throttled so that queued frames cannot starve the
+   * TCP write buffers.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return NULL;
+    }
+
+  ret = iob_trycopyin(iob, dev->d_buf, dev->d_len, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return NULL;
+    }
+
+  return iob;
+}
+
+#endif /* CONFIG_NET && CONFIG_NETDEV_IOB */
@@ -0,0 +1,159 @@
+/****************************************************************************
+ * net/procfs/net_iobstats.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <nuttx/net/iob.h>
+
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_IOB_STATISTICS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* Line generating functions */
+
+static int netprocfs_iobpool(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_iobfail(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_IOB_ELASTIC
+static int netprocfs_iobheap(FAR struct netprocfs_file_s *netfile);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_linegen[] =
+{
+  netprocfs_iobpool,
+  netprocfs_iobfail
+#ifdef CONFIG_IOB_ELASTIC
+  , netprocfs_iobheap
+#endif
+};
+
+#define NIOB_LINES (sizeof(g_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_iobpool
+ ****************************************************************************/
+
+static int netprocfs_iobpool(FAR struct netprocfs_file_s *netfile)
+{
+  struct iob_stats_s stats;
+
+  iob_stats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "IOBs: %u Free: %u In use: %u (max %u) Size: %u\n",
+                  stats.nbuffers, stats.nfree, stats.ninuse, stats.maxinuse,
+                  CONFIG_IOB_BUFSIZE);
+}
+
+/****************************************************************************
+ * Name: netprocfs_iobfail
+ ****************************************************************************/
+
+static int netprocfs_iobfail(FAR struct netprocfs_file_s *netfile)
+{
+  struct iob_stats_s stats;
+
+  iob_stats(&stats);
+  return snprintf(netfile->line, NET_LINELEN, "Failed: %lu\n",
+                  (unsigned long)stats.nfailed);
+}
+
+/****************************************************************************
+ * Name: netprocfs_iobheap
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ELASTIC
+static int netprocfs_iobheap(FAR struct netprocfs_file_s *netfile)
+{
+  struct iob_stats_s stats;
+
+  iob_stats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Heap: grown %lu shrunk %lu (min %u max %u)\n",
+                  (unsigned long)stats.ngrow, (unsigned long)stats.nshrink,
+                  CONFIG_IOB_NBUFFERS, CONFIG_IOB_MAXBUFFERS);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_iobstats
+ *
+ * Description:
+ *   Read and format the I/O buffer statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which I/O buffer statistics
+ *            will be returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_iobstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen, g_linegen, NIOB_LINES);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_IOB_STATISTICS */
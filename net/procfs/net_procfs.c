@@ -64,6 +64,39 @@
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of directory entries that precede the network devices */
+
+#ifdef CONFIG_NET_STATISTICS
+#  define NETPROCFS_NSTAT 1
+#else
+#  define NETPROCFS_NSTAT 0
+#endif
+
+#ifdef CONFIG_NET_TCP
+#  define NETPROCFS_NTCP  1
+#else
+#  define NETPROCFS_NTCP  0
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATS
+#  define NETPROCFS_NLOCK 1
+#else
+#  define NETPROCFS_NLOCK 0
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+#  define NETPROCFS_NIOB  1
+#else
+#  define NETPROCFS_NIOB  0
+#endif
+
+#define NETPROCFS_NFILES  (NETPROCFS_NSTAT + NETPROCFS_NTCP + NETPROCFS_NLOCK + \
+                           NETPROCFS_NIOB)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -125,6 +158,7 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct netprocfs_file_s *priv;
   FAR struct net_driver_s *dev;
+  uint8_t entry;
 
   finfo("Open '%s'\n", relpath);
 
@@ -152,7 +186,32 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
        * the network statistics file.
        */
 
-      dev = NULL;
+      entry = NETPROCFS_STAT;
+      dev   = NULL;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_TCP
+  if (strcmp(relpath, "net/tcp") == 0)
+    {
+      entry = NETPROCFS_TCP;
+      dev   = NULL;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_LOCK_STATS
+  if (strcmp(relpath, "net/lock") == 0)
+    {
+      entry = NETPROCFS_LOCK;
+      dev   = NULL;
+    }
+  else
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  if (strcmp(relpath, "net/iob") == 0)
+    {
+      entry = NETPROCFS_IOB;
+      dev   = NULL;
     }
   else
 #endif
@@ -180,6 +239,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
           ferr("ERROR: relpath is '%s'\n", relpath);
           return -ENOENT;
         }
+
+      entry = NETPROCFS_DEVICE;
     }
 
   /* Allocate the open file structure */
@@ -193,7 +254,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Initialize the open-file structure */
 
-  priv->dev = dev;
+  priv->dev   = dev;
+  priv->entry = entry;
 
   /* Save the open file structure as the open-specific state in
    * filep->f_priv.
@@ -240,24 +302,46 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
   priv = (FAR struct netprocfs_file_s *)filep->f_priv;
   DEBUGASSERT(priv);
 
+  switch (priv->entry)
+    {
 #ifdef CONFIG_NET_STATISTICS
-  /* A NULL device structure reference is the key that we are showing the
-   * network statistics.
-   */
+      case NETPROCFS_STAT:
+        /* Show the network layer statistics */
 
-  if (priv->dev == NULL)
-    {
-      /* Show the network layer statistics */
+        nreturned = netprocfs_read_netstats(priv, buffer, buflen);
+        break;
+#endif
 
-      nreturned = netprocfs_read_netstats(priv, buffer, buflen);
-    }
-  else
+#ifdef CONFIG_NET_TCP
+      case NETPROCFS_TCP:
+        /* Show the state of each TCP connection */
+
+        nreturned = netprocfs_read_tcpstats(priv, buffer, buflen);
+        break;
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATS
+      case NETPROCFS_LOCK:
+        /* Show the network lock statistics */
+
+        nreturned = netprocfs_read_lockstats(priv, buffer, buflen);
+        break;
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+      case NETPROCFS_IOB:
+        /* Show the I/O buffer statistics */
+
+        nreturned = netprocfs_read_iobstats(priv, buffer, buflen);
+        break;
 #endif
-   {
-      /* Otherwise, we are showing device-specific statistics */
 
-      nreturned = netprocfs_read_devstats(priv, buffer, buflen);
-   }
+      default:
+        /* Otherwise, we are showing device-specific statistics */
+
+        nreturned = netprocfs_read_devstats(priv, buffer, buflen);
+        break;
+    }
 
   /* Update the file offset */
 
@@ -358,11 +442,7 @@ static int netprocfs_opendir(FAR const char *relpath,
   /* Initialze base structure components */
 
   level1->base.level    = 1;
-#ifdef CONFIG_NET_STATISTICS
-  level1->base.nentries = ndevs + 1;
-#else
-  level1->base.nentries = ndevs;
-#endif
+  level1->base.nentries = ndevs + NETPROCFS_NFILES;
   level1->base.index    = 0;
 
   dir->u.procfs = (FAR void *) level1;
@@ -432,18 +512,39 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
       dir->fd_dir.d_type = DTYPE_FILE;
       strncpy(dir->fd_dir.d_name, "stat", NAME_MAX + 1);
     }
-  else
 #endif
+#ifdef CONFIG_NET_TCP
+  else if (index == NETPROCFS_NSTAT)
     {
-      int devndx = index;
+      /* Copy the TCP connection state directory entry */
 
-#ifdef CONFIG_NET_STATISTICS
-      /* Subtract one to account for index == 0 which is used for network
-       * status.
-       */
+      dir->fd_dir.d_type = DTYPE_FILE;
+      strncpy(dir->fd_dir.d_name, "tcp", NAME_MAX + 1);
+    }
+#endif
+#ifdef CONFIG_NET_LOCK_STATS
+  else if (index == NETPROCFS_NSTAT + NETPROCFS_NTCP)
+    {
+      /* Copy the network lock statistics directory entry */
+
+      dir->fd_dir.d_type = DTYPE_FILE;
+      strncpy(dir->fd_dir.d_name, "lock", NAME_MAX + 1);
+    }
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  else if (index == NETPROCFS_NSTAT + NETPROCFS_NTCP + NETPROCFS_NLOCK)
+    {
+      /* Copy the I/O buffer statistics directory entry */
 
-      devndx--;
+      dir->fd_dir.d_type = DTYPE_FILE;
+      strncpy(dir->fd_dir.d_name, "iob", NAME_MAX + 1);
+    }
 #endif
+  else
+    {
+      /* Subtract the entries that precede the network devices */
+
+      int devndx = index - NETPROCFS_NFILES;
 
       /* Find the device corresponding to this device index */
 
@@ -505,6 +606,33 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
     }
   else
+#endif
+#ifdef CONFIG_NET_TCP
+  /* Check for TCP connection state "net/tcp" */
+
+  if (strcmp(relpath, "net/tcp") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_LOCK_STATS
+  /* Check for network lock statistics "net/lock" */
+
+  if (strcmp(relpath, "net/lock") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  /* Check for I/O buffer statistics "net/iob" */
+
+  if (strcmp(relpath, "net/iob") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
 #endif
     {
       FAR struct net_driver_s *dev;
@@ -70,6 +70,9 @@ static int     netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+static int     netprocfs_tcp_ooseq(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_TCP_OUT_OF_ORDER */
 static int     netprocfs_prototype(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
@@ -103,6 +106,10 @@ static const linegen_t g_linegen[] =
   netprocfs_tcp_dropped_2,
 #endif /* CONFIG_NET_TCP */
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  netprocfs_tcp_ooseq,
+#endif /* CONFIG_NET_TCP_OUT_OF_ORDER */
+
   netprocfs_prototype,
   netprocfs_sent
 
@@ -320,6 +327,19 @@ static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_tcp_ooseq
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_OUT_OF_ORDER)
+static int netprocfs_tcp_ooseq(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  TCP OOSeq   Rtn: %04x  Drop: %04x\n",
+                  g_netstats.tcp.ooseq, g_netstats.tcp.oodrop);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP_OUT_OF_ORDER */
+
 /****************************************************************************
  * Name: netprocfs_prototype
  ****************************************************************************/
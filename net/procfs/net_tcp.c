@@ -0,0 +1,212 @@
+/****************************************************************************
+ * net/procfs/net_tcp.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_TCP)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_tcp_header
+ ****************************************************************************/
+
+static int netprocfs_tcp_header(FAR struct netprocfs_file_s *netfile)
+{
+#ifdef CONFIG_NET_TCP_CC
+  return snprintf(netfile->line, NET_LINELEN,
+                  "LPort RPort St Unacked Window     Cwnd   SSThresh\n");
+#else
+  return snprintf(netfile->line, NET_LINELEN,
+                  "LPort RPort St Unacked Window\n");
+#endif
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcp_conn
+ *
+ * Description:
+ *   Format the line describing the connection at index (lineno - 1) in the
+ *   list of active connections.  Returns zero if there is no such
+ *   connection.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcp_conn(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct tcp_conn_s *conn;
+  int index;
+  int len = 0;
+
+  net_lock();
+
+  conn = tcp_nextconn(NULL);
+  for (index = 1; conn != NULL && index < netfile->lineno; index++)
+    {
+      conn = tcp_nextconn(conn);
+    }
+
+  if (conn != NULL)
+    {
+      len = snprintf(netfile->line, NET_LINELEN, "%5u %5u %02x %7lu %6lu",
+                     ntohs(conn->lport), ntohs(conn->rport),
+                     conn->tcpstateflags & TCP_STATE_MASK,
+                     (unsigned long)conn->unacked,
+                     (unsigned long)conn->winsize);
+#ifdef CONFIG_NET_TCP_CC
+      len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                      " %8lu %10lu", (unsigned long)conn->cwnd,
+                      (unsigned long)conn->ssthresh);
+#endif
+      len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+    }
+
+  net_unlock();
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the state of each active TCP connection.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which connection status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  size_t xfrsize;
+  ssize_t nreturned = 0;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* The number of connections is not known in advance so the line
+   * generation table logic cannot be used:  Line zero is the header and
+   * each following line describes one connection, until there are no
+   * more connections.
+   */
+
+  for (; ; )
+    {
+      /* Transfer any line data that is already buffered */
+
+      if (priv->linesize > 0)
+        {
+          xfrsize = priv->linesize;
+          if (xfrsize > buflen)
+            {
+              xfrsize = buflen;
+            }
+
+          memcpy(buffer, &priv->line[priv->offset], xfrsize);
+
+          buffer         += xfrsize;
+          buflen         -= xfrsize;
+
+          priv->linesize -= xfrsize;
+          priv->offset   += xfrsize;
+          nreturned      += xfrsize;
+        }
+
+      /* Stop when the user buffer is full, or when there are no more
+       * connections (or too many to count with lineno).
+       */
+
+      if (buflen == 0 || priv->lineno == UINT8_MAX)
+        {
+          break;
+        }
+
+      if (priv->lineno == 0)
+        {
+          priv->linesize = netprocfs_tcp_header(priv);
+        }
+      else
+        {
+          priv->linesize = netprocfs_tcp_conn(priv);
+        }
+
+      priv->offset = 0;
+      if (priv->linesize == 0)
+        {
+          /* Don't look again on the next read */
+
+          priv->lineno = UINT8_MAX;
+          break;
+        }
+
+      priv->lineno++;
+    }
+
+  return nreturned;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_TCP */
@@ -56,6 +56,14 @@
 
 #define NET_LINELEN 64
 
+/* The kinds of files supported by the network procfs */
+
+#define NETPROCFS_DEVICE  0          /* Network device statistics */
+#define NETPROCFS_STAT    1          /* Network layer statistics */
+#define NETPROCFS_TCP     2          /* TCP connection state */
+#define NETPROCFS_LOCK    3          /* Network lock statistics */
+#define NETPROCFS_IOB     4          /* I/O buffer statistics */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -67,6 +75,7 @@ struct netprocfs_file_s
 {
   struct procfs_file_s base;         /* Base open file structure */
   FAR struct net_driver_s *dev;      /* Current network device */
+  uint8_t entry;                     /* See NETPROCFS_* definitions */
   uint8_t lineno;                    /* Line number */
   uint8_t linesize;                  /* Number of valid characters in line[] */
   uint8_t offset;                    /* Offset to first valid character in line[] */
@@ -169,6 +178,75 @@ ssize_t netprocfs_read_netstats(FAR struct netprocfs_file_s *priv,
 ssize_t netprocfs_read_devstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the state of each active TCP connection.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which connection status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_read_lockstats
+ *
+ * Description:
+ *   Read and format the network lock statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which lock statistics will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+ssize_t netprocfs_read_lockstats(FAR struct netprocfs_file_s *priv,
+                                 FAR char *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_read_iobstats
+ *
+ * Description:
+ *   Read and format the I/O buffer statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which I/O buffer statistics
+ *            will be returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_STATISTICS
+ssize_t netprocfs_read_iobstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
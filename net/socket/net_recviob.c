@@ -0,0 +1,514 @@
+/****************************************************************************
+ * net/socket/net_recviob.c
+ * Zero-copy receive from the read-ahead buffers
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_RECVIOB)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a receive operation that is waiting for data */
+
+struct recviob_s
+{
+  FAR struct devif_callback_s *ri_cb;  /* Reference to callback instance */
+  sem_t ri_sem;                        /* Wakes the waiting thread */
+  int ri_result;                       /* OK or a negated errno value */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recviob_wakeup
+ *
+ * Description:
+ *   Disable further callbacks and wake up the waiting thread.
+ *
+ ****************************************************************************/
+
+static void recviob_wakeup(FAR struct recviob_s *pstate, int result)
+{
+  pstate->ri_cb->flags = 0;
+  pstate->ri_cb->priv  = NULL;
+  pstate->ri_cb->event = NULL;
+  pstate->ri_result    = result;
+
+  sem_post(&pstate->ri_sem);
+}
+
+/****************************************************************************
+ * Function: recviob_tcp_interrupt
+ *
+ * Description:
+ *   Wake up the waiting thread when new data arrives on the TCP connection
+ *   or when the connection is lost.  TCP_NEWDATA is left set so that the
+ *   data is placed in the read-ahead buffers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+static uint16_t recviob_tcp_interrupt(FAR struct net_driver_s *dev,
+                                      FAR void *pvconn, FAR void *pvpriv,
+                                      uint16_t flags)
+{
+  FAR struct recviob_s *pstate = (FAR struct recviob_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL)
+    {
+      if ((flags & TCP_DISCONN_EVENTS) != 0)
+        {
+          /* The caller will find the socket disconnected */
+
+          recviob_wakeup(pstate, OK);
+        }
+      else if ((flags & TCP_NEWDATA) != 0)
+        {
+          recviob_wakeup(pstate, OK);
+        }
+    }
+
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Function: recviob_udp_interrupt
+ *
+ * Description:
+ *   Wake up the waiting thread when a new datagram arrives or when the
+ *   network goes down.  UDP_NEWDATA is left set so that the datagram is
+ *   placed in the read-ahead buffers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+static uint16_t recviob_udp_interrupt(FAR struct net_driver_s *dev,
+                                      FAR void *pvconn, FAR void *pvpriv,
+                                      uint16_t flags)
+{
+  FAR struct recviob_s *pstate = (FAR struct recviob_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL)
+    {
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          nerr("ERROR: Network is down\n");
+          recviob_wakeup(pstate, -ENETUNREACH);
+        }
+      else if ((flags & UDP_NEWDATA) != 0)
+        {
+          recviob_wakeup(pstate, OK);
+        }
+    }
+
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Function: recviob_tcp_take
+ *
+ * Description:
+ *   Remove the I/O buffer chain at the head of the TCP read-ahead queue.
+ *
+ * Returned Value:
+ *   The number of bytes of data in the chain; -EAGAIN if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+static ssize_t recviob_tcp_take(FAR struct tcp_conn_s *conn,
+                                FAR struct iob_s **iobp)
+{
+  FAR struct iob_s *iob;
+
+  iob = iob_remove_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  *iobp = iob;
+  return iob->io_pktlen;
+}
+#endif
+
+/****************************************************************************
+ * Function: recviob_udp_take
+ *
+ * Description:
+ *   Remove the datagram at the head of the UDP read-ahead queue, returning
+ *   the sender's address and an I/O buffer chain holding only the data.
+ *
+ * Returned Value:
+ *   The number of bytes of data in the chain; -EAGAIN if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+static ssize_t recviob_udp_take(FAR struct udp_conn_s *conn,
+                                FAR struct iob_s **iobp,
+                                FAR struct sockaddr *from,
+                                FAR socklen_t *fromlen)
+{
+  FAR struct iob_s *iob;
+  uint8_t addrlen;
+
+  iob = iob_remove_queue(&conn->readahead);
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  /* The datagram is preceded by the size of the sender's address and the
+   * address itself.
+   */
+
+  if (iob_copyout(&addrlen, iob, sizeof(uint8_t), 0) != sizeof(uint8_t))
+    {
+      iob_free_chain(iob);
+      return -EAGAIN;
+    }
+
+  if (from != NULL)
+    {
+      socklen_t len = *fromlen < addrlen ? *fromlen : addrlen;
+
+      (void)iob_copyout((FAR uint8_t *)from, iob, len, sizeof(uint8_t));
+      *fromlen = addrlen;
+    }
+
+  iob   = iob_trimhead(iob, addrlen + sizeof(uint8_t));
+  *iobp = iob;
+  return iob->io_pktlen;
+}
+#endif
+
+/****************************************************************************
+ * Function: recviob_wait
+ *
+ * Description:
+ *   Wait for the connection callback to report new data, disconnection,
+ *   or a lost network, honoring any receive timeout.
+ *
+ * Returned Value:
+ *   OK when there may be more data to take; a negated errno value on
+ *   failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int recviob_wait(FAR struct socket *psock)
+{
+  struct recviob_s state;
+  FAR struct timespec *abstime = NULL;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec timeout;
+#endif
+#ifdef CONFIG_NET_UDP_READAHEAD
+  FAR struct net_driver_s *dev = NULL;
+#endif
+  int ret;
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (psock->s_rcvtimeo != 0)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &timeout);
+      timeout.tv_sec  += psock->s_rcvtimeo / DSEC_PER_SEC;
+      timeout.tv_nsec += (psock->s_rcvtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (timeout.tv_nsec >= NSEC_PER_SEC)
+        {
+          timeout.tv_sec++;
+          timeout.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      abstime = &timeout;
+    }
+#endif
+
+  (void)sem_init(&state.ri_sem, 0, 0);
+  state.ri_result = OK;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+      state.ri_cb = tcp_callback_alloc(conn);
+      if (state.ri_cb == NULL)
+        {
+          ret = -EBUSY;
+          goto errout_with_sem;
+        }
+
+      state.ri_cb->flags = (TCP_NEWDATA | TCP_DISCONN_EVENTS);
+      state.ri_cb->priv  = (FAR void *)&state;
+      state.ri_cb->event = recviob_tcp_interrupt;
+
+      ret = net_timedwait(&state.ri_sem, abstime);
+      tcp_callback_free(conn, state.ri_cb);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_UDP_READAHEAD
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+      dev = udp_find_laddr_device(conn);
+      state.ri_cb = udp_callback_alloc(dev, conn);
+      if (state.ri_cb == NULL)
+        {
+          ret = -EBUSY;
+          goto errout_with_sem;
+        }
+
+      state.ri_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+      state.ri_cb->priv  = (FAR void *)&state;
+      state.ri_cb->event = recviob_udp_interrupt;
+
+      ret = net_timedwait(&state.ri_sem, abstime);
+      udp_callback_free(dev, conn, state.ri_cb);
+    }
+  else
+#endif
+    {
+      ret = -EOPNOTSUPP;
+      goto errout_with_sem;
+    }
+
+  /* net_timedwait() returns -1 with the errno value set on a failure */
+
+  if (ret < 0)
+    {
+      ret = -get_errno();
+      if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+        }
+    }
+  else
+    {
+      ret = state.ri_result;
+    }
+
+errout_with_sem:
+  (void)sem_destroy(&state.ri_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_recvfrom_iob
+ *
+ * Description:
+ *   Receive data from a TCP or UDP socket without copying it:  The I/O
+ *   buffer chain holding the data is removed from the socket's read-ahead
+ *   buffers and returned to the caller, who must release it with
+ *   iob_free_chain() when the data has been consumed.
+ *
+ *   For a TCP socket, the chain holds the data of one or more received
+ *   segments.  For a UDP socket, it holds exactly one datagram and, if
+ *   from is not NULL, the sender's address is returned as by recvfrom().
+ *   from is not used with TCP sockets.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iobp     The location to return the I/O buffer chain
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned I/O buffer
+ *   chain.  Zero is returned with *iobp set to NULL if the TCP peer has
+ *   performed an orderly shutdown.  Otherwise, on errors, -1 is returned,
+ *   and errno is set as for recvfrom().  EOPNOTSUPP is reported for a
+ *   socket type without read-ahead buffering.
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvfrom_iob(FAR struct socket *psock, FAR struct iob_s **iobp,
+                           FAR struct sockaddr *from,
+                           FAR socklen_t *fromlen)
+{
+  ssize_t ret;
+  int errcode;
+
+  /* Treat as a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  if (iobp == NULL || (from != NULL && fromlen == NULL))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      errcode = EBADF;
+      goto errout;
+    }
+
+  *iobp = NULL;
+
+  net_lock();
+  for (; ; )
+    {
+      /* Take any data that is already buffered.  NOTE that there may be
+       * read-ahead data to be retrieved even after the socket has been
+       * disconnected.
+       */
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (psock->s_type == SOCK_STREAM)
+        {
+          ret = recviob_tcp_take((FAR struct tcp_conn_s *)psock->s_conn,
+                                 iobp);
+          if (ret < 0 && !_SS_ISCONNECTED(psock->s_flags))
+            {
+              /* Return end-of-file after a graceful close */
+
+              ret = _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+            }
+        }
+      else
+#endif
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (psock->s_type == SOCK_DGRAM)
+        {
+          ret = recviob_udp_take((FAR struct udp_conn_s *)psock->s_conn,
+                                 iobp, from, fromlen);
+        }
+      else
+#endif
+        {
+          ret = -EOPNOTSUPP;
+        }
+
+      if (ret != -EAGAIN || _SS_ISNONBLOCK(psock->s_flags))
+        {
+          break;
+        }
+
+      /* Nothing is buffered.  Wait for something to arrive. */
+
+      ret = recviob_wait(psock);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno(errcode);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+/****************************************************************************
+ * Function: recvfrom_iob
+ *
+ * Description:
+ *   Receive data from a TCP or UDP socket without copying it.  See
+ *   psock_recvfrom_iob().
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   iobp     The location to return the I/O buffer chain
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   See psock_recvfrom_iob().
+ *
+ ****************************************************************************/
+
+ssize_t recvfrom_iob(int sockfd, FAR struct iob_s **iobp,
+                     FAR struct sockaddr *from, FAR socklen_t *fromlen)
+{
+  return psock_recvfrom_iob(sockfd_socket(sockfd), iobp, from, fromlen);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_RECVIOB */
@@ -285,3 +285,60 @@ ssize_t send(int sockfd, FAR const void *buf, size_t len, int flags)
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Function: send_zerocopy
+ *
+ * Description:
+ *   Send data on a connected TCP socket without copying it into the write
+ *   buffers.  See include/nuttx/net/net.h.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   notify   Called when the data is no longer referenced
+ *   arg      Argument passed to notify
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  On error, -1 is
+ *   returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+ssize_t send_zerocopy(int sockfd, FAR const void *buf, size_t len,
+                      send_zcnotify_t notify, FAR void *arg)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* send_zerocopy() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Only TCP stream sockets support zero-copy sends */
+
+  if (psock != NULL &&
+#ifdef CONFIG_NET_LOCAL_STREAM
+      (psock->s_type != SOCK_STREAM || psock->s_domain == PF_LOCAL))
+#else
+      psock->s_type != SOCK_STREAM)
+#endif
+    {
+      set_errno(EOPNOTSUPP);
+      ret = ERROR;
+    }
+  else
+    {
+      ret = psock_tcp_send_zerocopy(psock, buf, len, notify, arg);
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+#endif
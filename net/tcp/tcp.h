@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <queue.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/iob.h>
 #include <nuttx/net/ip.h>
 
@@ -68,7 +69,7 @@
  */
 
 #  define tcp_callback_alloc(conn) \
-    devif_callback_alloc(conn->dev, &conn->list)
+    tcp_callback_pend(conn, devif_callback_alloc(conn->dev, &conn->list))
 #  define tcp_callback_free(conn,cb) \
     devif_conn_callback_free(conn->dev, cb, &conn->list)
 
@@ -87,7 +88,7 @@
  */
 
 #  define tcp_callback_alloc(conn) \
-    devif_callback_alloc(g_netdevices, &conn->list)
+    tcp_callback_pend(conn, devif_callback_alloc(g_netdevices, &conn->list))
 #  define tcp_callback_free(conn,cb) \
     devif_conn_callback_free(g_netdevices, cb, &conn->list)
 
@@ -101,6 +102,14 @@
     devif_conn_callback_free(g_netdevices, cb, NULL)
 #endif
 
+/* A connection with a newly allocated data callback is added to the list of
+ * connections that are visited when the network device is polled.
+ */
+
+#ifndef CONFIG_NET_TCP_POLL_PENDING
+#  define tcp_callback_pend(conn,cb) (cb)
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 /* TCP write buffer access macros */
 
@@ -112,8 +121,42 @@
 #  define WRB_COPYOUT(wrb,dest,n) (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define WRB_COPYIN(wrb,src,n)   (iob_copyin((wrb)->wb_iob,src,(n),0,false))
 
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+/* A zero-copy write buffer has no I/O buffer chain.  It refers to the
+ * caller's data until all of it has been ACKed.
+ */
+
+#  undef  WRB_PKTLEN
+#  define WRB_ISZEROCOPY(wrb)     ((wrb)->wb_iob == NULL)
+#  define WRB_PKTLEN(wrb) \
+     (WRB_ISZEROCOPY(wrb) ? (wrb)->wb_buflen : (wrb)->wb_iob->io_pktlen)
+#  define WRB_BUFFER(wrb)         ((wrb)->wb_buffer)
+#  define WRB_SETACKED(wrb)       do { (wrb)->wb_buflen = 0; } while (0)
+
+#  define WRB_TRIM(wrb,n) \
+  do \
+    { \
+      if (WRB_ISZEROCOPY(wrb)) \
+        { \
+          (wrb)->wb_buffer += (n); \
+          (wrb)->wb_buflen -= (n); \
+        } \
+      else \
+        { \
+          (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); \
+        } \
+    } \
+  while (0)
+#else
+#  define WRB_SETACKED(wrb)
+
 #  define WRB_TRIM(wrb,n) \
   do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+#  define WRB_SACKED(wrb)         ((wrb)->wb_sacked)
+#endif
 
 #ifdef CONFIG_DEBUG_FEATURES
 #  define WRB_DUMP(msg,wrb,len,offset) \
@@ -123,6 +166,13 @@
 #endif
 #endif
 
+/* Bits in the tcpopts field of struct tcp_conn_s:  TCP options that were
+ * successfully negotiated with the peer.
+ */
+
+#define TCP_OPTF_WSCALE           (1 << 0) /* Window scaling (RFC 7323) */
+#define TCP_OPTF_SACK             (1 << 1) /* Selective ACK (RFC 2018) */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -141,9 +191,38 @@ struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
 
+/* This structure describes one block of a SACK option */
+
+#ifdef CONFIG_NET_TCP_SACK
+struct tcp_sackblk_s
+{
+  uint32_t left;          /* Sequence number of the first byte in the block */
+  uint32_t right;         /* Sequence number following the last byte */
+};
+#endif
+
+/* This structure describes one segment retained in the out-of-order queue */
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+struct tcp_ooseq_s
+{
+  uint32_t seqno;         /* Sequence number of the first byte in iob */
+  FAR struct iob_s *iob;  /* I/O buffer chain holding the segment data */
+};
+#endif
+
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s *hnext;  /* Next active connection in hash bucket */
+  FAR struct tcp_conn_s *lpnext; /* Next connection in local port bucket */
+#endif
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  FAR struct tcp_conn_s *pflink; /* Next connection in the poll list */
+  FAR struct tcp_conn_s *pblink; /* Previous connection in the poll list */
+  uint8_t  pending;       /* True: Connection is in the poll list */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -165,7 +244,19 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_SACK)
+  uint8_t  tcpopts;       /* Negotiated options.  See TCP_OPTF_* */
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  sndscale;      /* Shift applied to windows advertised by the
+                           * peer */
+  uint8_t  rcvscale;      /* Shift applied to windows that we advertise */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -191,6 +282,19 @@ struct tcp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* Out-of-order segments
+   *
+   *   ooseq  - Segments received beyond a gap in the sequence space,
+   *            ordered by sequence number.  These are moved to the
+   *            read-ahead buffers when the gap is filled.
+   *   nooseq - The number of valid entries in ooseq[].
+   */
+
+  struct tcp_ooseq_s ooseq[CONFIG_NET_TCP_OOSEQ_NSEGS];
+  uint8_t nooseq;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -210,6 +314,27 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cwnd     - The congestion window:  The maximum number of un-ACKed
+   *              bytes that may be in flight.
+   *   ssthresh - The slow start threshold.  Slow start is used while cwnd
+   *              is below this value; congestion avoidance above it.
+   *   recover  - The value of sndseq_max when fast recovery was entered.
+   *   lastack  - The highest acknowledgement number received.
+   *   dupacks  - The number of consecutive duplicate ACKs received.
+   *   infast   - True while in fast recovery.
+   */
+
+  uint32_t   cwnd;        /* Congestion window */
+  uint32_t   ssthresh;    /* Slow start threshold */
+  uint32_t   recover;     /* Fast recovery point */
+  uint32_t   lastack;     /* Last acknowledgement number received */
+  uint8_t    dupacks;     /* Count of duplicate ACKs */
+  uint8_t    infast;      /* Non-zero:  In fast recovery */
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -291,7 +416,17 @@ struct tcp_wrbuffer_s
   uint16_t   wb_sent;      /* Number of bytes sent from the I/O buffer chain */
   uint8_t    wb_nrtx;      /* The number of retransmissions for the last
                             * segment sent */
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+  uint8_t    wb_sacked;    /* True: Entire segment has been SACKed */
+#endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+  FAR const uint8_t *wb_buffer; /* Caller's data if there is no I/O buffer
+                                 * chain */
+  uint16_t   wb_buflen;    /* Number of bytes of un-ACKed data at wb_buffer */
+  send_zcnotify_t wb_notify; /* Called when wb_buffer is no longer used */
+  FAR void  *wb_arg;       /* Argument passed to wb_notify */
+#endif
 };
 #endif
 
@@ -409,6 +544,46 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_callback_pend
+ *
+ * Description:
+ *   Add the connection to the list of connections that are visited when
+ *   the network device is polled.  This is called each time that a data
+ *   callback is allocated for the connection.
+ *
+ * Returned Value:
+ *   The callback structure 'cb' is returned.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+FAR struct devif_callback_s *
+  tcp_callback_pend(FAR struct tcp_conn_s *conn,
+                    FAR struct devif_callback_s *cb);
+#endif
+
+/****************************************************************************
+ * Name: tcp_nextpending
+ *
+ * Description:
+ *   Traverse the list of TCP connections that may have data to send when
+ *   polled.  As the traversal moves past a connection, that connection is
+ *   removed from the list if it no longer has any callback that responds to
+ *   TCP_POLL.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+FAR struct tcp_conn_s *tcp_nextpending(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Function: tcp_local_ipv4_device
  *
@@ -770,6 +945,19 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len);
 
+/****************************************************************************
+ * Name: tcp_wscale
+ *
+ * Description:
+ *   Return the window scale shift that we offer to the peer:  The smallest
+ *   shift that allows the device's receive window to be advertised.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_wscale(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: tcp_reset
  *
@@ -944,6 +1132,124 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t nbytes);
 #endif
 
+/****************************************************************************
+ * Function: tcp_sack_build
+ *
+ * Description:
+ *   Format a SACK option describing the out-of-order data retained by the
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure
+ *   opt  - The location in the TCP header at which to build the option
+ *
+ * Returned value:
+ *   The number of bytes of option data, a multiple of four.  Zero is
+ *   returned if no out-of-order data is retained.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+unsigned int tcp_sack_build(FAR struct tcp_conn_s *conn, FAR uint8_t *opt);
+#endif
+
+/****************************************************************************
+ * Function: tcp_sack_parse
+ *
+ * Description:
+ *   Extract the blocks of the SACK option, if any, from a received TCP
+ *   header.
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   blocks - The location to return the SACK blocks
+ *
+ * Returned value:
+ *   The number of SACK blocks returned, up to TCP_MAX_SACKBLKS.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+int tcp_sack_parse(FAR struct tcp_hdr_s *tcp,
+                   FAR struct tcp_sackblk_s *blocks);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ooseq_add
+ *
+ * Description:
+ *   Retain the data from a segment that was received beyond a gap in the
+ *   sequence space.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the segment
+ *   conn   - The TCP connection structure
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - A pointer to the segment data
+ *   buflen - The number of bytes of segment data
+ *
+ * Returned value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+void tcp_ooseq_add(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                   uint32_t seqno, FAR const uint8_t *buffer,
+                   uint16_t buflen);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ooseq_deliver
+ *
+ * Description:
+ *   Move any retained out-of-order data that is now contiguous with
+ *   conn->rcvseq to the read-ahead buffers and advance conn->rcvseq past
+ *   it.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+void tcp_ooseq_deliver(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ooseq_free
+ *
+ * Description:
+ *   Release all retained out-of-order data.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+void tcp_ooseq_free(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_ooseq_count
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the retained out-of-order
+ *   data.  These count against the read-ahead quota of the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+unsigned int tcp_ooseq_count(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Function: tcp_backlogcreate
  *
@@ -1146,6 +1452,22 @@ struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Function: psock_tcp_send_zerocopy
+ *
+ * Description:
+ *   Like psock_tcp_send() except that the data is not copied:  The write
+ *   buffer refers to the caller's data, which must not be modified or
+ *   freed until notify is called.  See send_zerocopy().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+ssize_t psock_tcp_send_zerocopy(FAR struct socket *psock,
+                                FAR const void *buf, size_t len,
+                                send_zcnotify_t notify, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Function: psock_tcp_cansend
  *
@@ -1212,6 +1534,23 @@ struct tcp_wrbuffer_s;
 FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Function: tcp_wrbuffer_zcalloc
+ *
+ * Description:
+ *   Allocate a TCP write buffer that will refer to the caller's data rather
+ *   than holding a copy of it in an I/O buffer chain.  Otherwise, the same
+ *   as tcp_wrbuffer_alloc().
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_zcalloc(void);
+#endif
+
 /****************************************************************************
  * Function: tcp_wrbuffer_release
  *
@@ -1261,6 +1600,80 @@ void tcp_wrbuffer_dump(FAR const char *msg, FAR struct tcp_wrbuffer_s *wrb,
 #endif
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Function: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a newly established
+ *   connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion window on receipt of an ACK.  conn->unacked must
+ *   already reflect the acknowledgement.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   len    - The length of the payload carried by the incoming segment
+ *   wndupd - True if the incoming segment changed the peer's advertised
+ *            window
+ *
+ * Returned Value:
+ *   True if a fast retransmission should be performed.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, uint16_t len,
+                bool wndupd);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_cc_window
+ *
+ * Description:
+ *   Return the number of bytes that may be in flight:  The smaller of the
+ *   congestion window and the peer's receive window.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+uint32_t tcp_cc_window(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Function: tcp_pollsetup
  *
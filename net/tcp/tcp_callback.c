@@ -237,6 +237,22 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
   FAR struct iob_s *iob;
   int ret;
 
+#if CONFIG_NET_TCP_READAHEAD_QUOTA > 0
+  /* Do not let one connection take more than its share of the I/O buffers.
+   * The data will not be ACKed and the peer will retransmit it later.
+   *
+   * Retained out-of-order data is deliberately not counted:  In-order data
+   * may be the segment that fills the gap, and refusing it would leave the
+   * retained data stuck and the connection stalled.
+   */
+
+  if (iob_count_queue(&conn->readahead) >= CONFIG_NET_TCP_READAHEAD_QUOTA)
+    {
+      nwarn("WARNING: Read-ahead quota reached\n");
+      return 0;
+    }
+#endif
+
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
    * packet.
@@ -0,0 +1,291 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ * TCP congestion control for the buffered send path
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of duplicate ACKs that trigger a fast retransmission */
+
+#define TCP_CC_DUPTHRESH  3
+
+/* Modulo 2**32 sequence number comparisons */
+
+#define TCP_SEQ_LT(a,b)   ((int32_t)((a) - (b)) < 0)
+#define TCP_SEQ_GT(a,b)   ((int32_t)((a) - (b)) > 0)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_halfflight
+ *
+ * Description:
+ *   Return the new slow start threshold after a loss:  One half of the
+ *   data in flight, but not less than two segments (RFC 5681, eqn. 4).
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cc_halfflight(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = conn->unacked >> 1;
+  uint32_t minimum  = 2 * (uint32_t)conn->mss;
+
+  return ssthresh > minimum ? ssthresh : minimum;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a newly established
+ *   connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+#if CONFIG_NET_TCP_CC_INITWND > 0
+  conn->cwnd     = CONFIG_NET_TCP_CC_INITWND * mss;
+#else
+  /* RFC 3390: min(4*MSS, max(2*MSS, 4380 bytes)) */
+
+  conn->cwnd     = 2 * mss > 4380 ? 2 * mss : 4380;
+  if (conn->cwnd > 4 * mss)
+    {
+      conn->cwnd = 4 * mss;
+    }
+#endif
+
+  /* The initial slow start threshold is arbitrarily high so that the
+   * peer's receive window is the only limit until the first loss.
+   */
+
+  conn->ssthresh = UINT32_MAX;
+  conn->lastack  = tcp_getsequence(conn->sndseq);
+  conn->recover  = conn->lastack;
+  conn->dupacks  = 0;
+  conn->infast   = 0;
+
+  ninfo("cwnd=%lu\n", (unsigned long)conn->cwnd);
+}
+
+/****************************************************************************
+ * Function: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion window on receipt of an ACK.  conn->unacked must
+ *   already reflect the acknowledgement.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackseq - The acknowledgement number of the incoming segment
+ *   len    - The length of the payload carried by the incoming segment
+ *   wndupd - True if the incoming segment changed the peer's advertised
+ *            window
+ *
+ * Returned Value:
+ *   True if a fast retransmission should be performed.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackseq, uint16_t len,
+                bool wndupd)
+{
+  uint32_t mss = conn->mss;
+
+  if (TCP_SEQ_GT(ackseq, conn->lastack))
+    {
+      uint32_t acked = ackseq - conn->lastack;
+
+      /* New data has been acknowledged */
+
+      conn->lastack = ackseq;
+      conn->dupacks = 0;
+
+      if (conn->infast)
+        {
+          if (!TCP_SEQ_LT(ackseq, conn->recover))
+            {
+              /* A full ACK:  Everything outstanding when the loss was
+               * detected has been acknowledged.  Deflate the window and
+               * leave fast recovery (RFC 6582, section 3.2, step 3).
+               */
+
+              conn->cwnd   = conn->ssthresh;
+              conn->infast = 0;
+            }
+          else
+            {
+              /* A partial ACK:  Deflate the window by the amount of new
+               * data acknowledged and add back one segment.  The
+               * retransmission that RFC 6582 calls for here is not
+               * needed:  The fast retransmission re-queued all of the
+               * un-ACKed data, not only the first segment.
+               */
+
+              conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : 0;
+              conn->cwnd += mss;
+            }
+        }
+      else if (conn->cwnd < conn->ssthresh)
+        {
+          /* Slow start:  Grow by at most one segment per ACK */
+
+          conn->cwnd += acked < mss ? acked : mss;
+        }
+      else
+        {
+          /* Congestion avoidance:  Grow by about one segment per RTT */
+
+          uint32_t incr = (mss * mss) / conn->cwnd;
+          conn->cwnd += incr > 0 ? incr : 1;
+        }
+
+      return false;
+    }
+
+  /* A duplicate ACK acknowledges nothing new, carries no data, does not
+   * change the advertised window, and is received while there is data
+   * outstanding (RFC 5681, section 2).  A pure window update is not a
+   * duplicate.
+   */
+
+  if (ackseq != conn->lastack || len > 0 || wndupd || conn->unacked == 0)
+    {
+      return false;
+    }
+
+  if (conn->infast)
+    {
+      /* Each additional duplicate ACK indicates that another segment has
+       * left the network.  Inflate the window accordingly.
+       */
+
+      conn->cwnd += mss;
+      return false;
+    }
+
+  if (++conn->dupacks < TCP_CC_DUPTHRESH)
+    {
+      return false;
+    }
+
+  /* Enter fast recovery */
+
+  conn->ssthresh = tcp_cc_halfflight(conn);
+  conn->cwnd     = conn->ssthresh + TCP_CC_DUPTHRESH * mss;
+  conn->recover  = conn->sndseq_max;
+  conn->dupacks  = 0;
+  conn->infast   = 1;
+
+  ninfo("Fast retransmit: ackseq=%08lx cwnd=%lu ssthresh=%lu\n",
+        (unsigned long)ackseq, (unsigned long)conn->cwnd,
+        (unsigned long)conn->ssthresh);
+
+  return true;
+}
+
+/****************************************************************************
+ * Function: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh = tcp_cc_halfflight(conn);
+  conn->cwnd     = conn->mss;
+  conn->dupacks  = 0;
+  conn->infast   = 0;
+
+  ninfo("RTO: cwnd=%lu ssthresh=%lu\n",
+        (unsigned long)conn->cwnd, (unsigned long)conn->ssthresh);
+}
+
+/****************************************************************************
+ * Function: tcp_cc_window
+ *
+ * Description:
+ *   Return the number of bytes that may be in flight:  The smaller of the
+ *   congestion window and the peer's receive window.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_window(FAR struct tcp_conn_s *conn)
+{
+  return conn->cwnd < conn->winsize ? conn->cwnd : conn->winsize;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
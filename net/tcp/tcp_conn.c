@@ -69,6 +69,10 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/* Select the local port hash bucket of a port number in network order */
+
+#define TCP_PORTHASH(p) (ntohs(p) % CONFIG_NET_TCP_CONN_NHASH)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -89,10 +93,326 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* Active connections hashed by local port, remote port, and remote IP
+ * address.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_CONN_NHASH];
+
+/* All connections with an assigned local port, hashed by the local port */
+
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_CONN_NHASH];
+#endif
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+/* A list of connections that have callbacks that may respond to TCP_POLL */
+
+static FAR struct tcp_conn_s *g_pending_tcp_connections;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Return the hash bucket for a connection with the given local port,
+ *   remote port, and remote IP address (all in network byte order).  IPv6
+ *   addresses are first folded into 32-bits with tcp_ipv6_fold().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static inline unsigned int tcp_hashkey(uint16_t lport, uint16_t rport,
+                                       uint32_t raddr)
+{
+  uint32_t key = raddr ^ (((uint32_t)lport << 16) | rport);
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key % CONFIG_NET_TCP_CONN_NHASH;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold a 128-bit IPv6 address into 32-bits for hashing.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_CONN_HASH) && defined(CONFIG_NET_IPv6)
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *ipaddr)
+{
+  return ((uint32_t)(ipaddr[0] ^ ipaddr[2] ^ ipaddr[4] ^ ipaddr[6]) << 16) |
+         (uint32_t)(ipaddr[1] ^ ipaddr[3] ^ ipaddr[5] ^ ipaddr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash
+ *
+ * Description:
+ *   Return the hash bucket of an active connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static unsigned int tcp_connhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hashkey(conn->lport, conn->rport,
+                         tcp_ipv6_fold(conn->u.ipv6.raddr));
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Add a connection to the list of active connections (and to the active
+ *   connection hash table).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  unsigned int ndx = tcp_connhash(conn);
+
+  conn->hnext          = g_tcp_connhash[ndx];
+  g_tcp_connhash[ndx]  = conn;
+#endif
+
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+}
+
+/****************************************************************************
+ * Name: tcp_remactive
+ *
+ * Description:
+ *   Remove a connection from the list of active connections (and from the
+ *   active connection hash table).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_remactive(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR struct tcp_conn_s *prev = NULL;
+  FAR struct tcp_conn_s *curr;
+  unsigned int ndx = tcp_connhash(conn);
+
+  for (curr = g_tcp_connhash[ndx]; curr != NULL; curr = curr->hnext)
+    {
+      if (curr == conn)
+        {
+          if (prev != NULL)
+            {
+              prev->hnext = conn->hnext;
+            }
+          else
+            {
+              g_tcp_connhash[ndx] = conn->hnext;
+            }
+
+          break;
+        }
+
+      prev = curr;
+    }
+#endif
+
+  dq_rem(&conn->node, &g_active_tcp_connections);
+}
+
+/****************************************************************************
+ * Name: tcp_addport
+ *
+ * Description:
+ *   Add a connection to the local port hash table after its local port
+ *   number has been assigned.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static void tcp_addport(FAR struct tcp_conn_s *conn)
+{
+  unsigned int ndx = TCP_PORTHASH(conn->lport);
+
+  conn->lpnext        = g_tcp_porthash[ndx];
+  g_tcp_porthash[ndx] = conn;
+}
+#else
+#  define tcp_addport(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_remport
+ *
+ * Description:
+ *   Remove a connection from the local port hash table.  This must be done
+ *   before the local port number of the connection is changed.  Nothing is
+ *   done if the connection is not in the hash table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+static void tcp_remport(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *prev = NULL;
+  FAR struct tcp_conn_s *curr;
+  unsigned int ndx;
+
+  if (conn->lport == 0)
+    {
+      return;
+    }
+
+  ndx = TCP_PORTHASH(conn->lport);
+  for (curr = g_tcp_porthash[ndx]; curr != NULL; curr = curr->lpnext)
+    {
+      if (curr == conn)
+        {
+          if (prev != NULL)
+            {
+              prev->lpnext = conn->lpnext;
+            }
+          else
+            {
+              g_tcp_porthash[ndx] = conn->lpnext;
+            }
+
+          break;
+        }
+
+      prev = curr;
+    }
+}
+#else
+#  define tcp_remport(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_nextport
+ *
+ * Description:
+ *   Traverse the connections that may be using the local port 'portno'
+ *   (network byte order).  The caller must still check the port number and
+ *   state of each connection returned.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_nextport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  if (conn == NULL)
+    {
+      return g_tcp_porthash[TCP_PORTHASH(portno)];
+    }
+
+  return conn->lpnext;
+#else
+  int ndx = (conn == NULL) ? 0 : (conn - g_tcp_connections) + 1;
+
+  return ndx < CONFIG_NET_TCP_CONNS ? &g_tcp_connections[ndx] : NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_pollwanted
+ *
+ * Description:
+ *   Return true if any callback of the connection responds to TCP_POLL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+static bool tcp_pollwanted(FAR struct tcp_conn_s *conn)
+{
+  FAR struct devif_callback_s *cb;
+
+  for (cb = conn->list; cb != NULL; cb = cb->nxtconn)
+    {
+      if ((cb->flags & TCP_POLL) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_rempending
+ *
+ * Description:
+ *   Remove a connection from the list of connections to be polled.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+static void tcp_rempending(FAR struct tcp_conn_s *conn)
+{
+  if (conn->pending)
+    {
+      if (conn->pblink != NULL)
+        {
+          conn->pblink->pflink = conn->pflink;
+        }
+      else
+        {
+          g_pending_tcp_connections = conn->pflink;
+        }
+
+      if (conn->pflink != NULL)
+        {
+          conn->pflink->pblink = conn->pblink;
+        }
+
+      conn->pflink  = NULL;
+      conn->pblink  = NULL;
+      conn->pending = 0;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -110,14 +430,13 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = tcp_nextport(NULL, portno);
+       conn != NULL;
+       conn = tcp_nextport(conn, portno))
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -161,14 +480,13 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = tcp_nextport(NULL, portno);
+       conn != NULL;
+       conn = tcp_nextport(conn, portno))
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -236,14 +554,13 @@ static FAR struct tcp_conn_s *
 static FAR struct tcp_conn_s *tcp_listener(uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = tcp_nextport(NULL, portno);
+       conn != NULL;
+       conn = tcp_nextport(conn, portno))
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -368,8 +685,13 @@ static inline FAR struct tcp_conn_s *
   in_addr_t destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_connhash[tcp_hashkey(tcp->destport, tcp->srcport,
+                                          srcipaddr)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 #endif
@@ -413,7 +735,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -443,8 +769,13 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  conn       = g_tcp_connhash[tcp_hashkey(tcp->destport, tcp->srcport,
+                                          tcp_ipv6_fold(*srcipaddr))];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 #endif
@@ -488,7 +819,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -539,6 +874,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
+  tcp_remport(conn);
   conn->lport = htons(port);
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
@@ -564,6 +900,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+  tcp_addport(conn);
   net_unlock();
   return OK;
 }
@@ -619,6 +956,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
+  tcp_remport(conn);
   conn->lport = htons(port);
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
@@ -644,6 +982,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
       return ret;
     }
 
+  tcp_addport(conn);
   net_unlock();
   return OK;
 }
@@ -671,6 +1010,18 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  for (i = 0; i < CONFIG_NET_TCP_CONN_NHASH; i++)
+    {
+      g_tcp_connhash[i] = NULL;
+      g_tcp_porthash[i] = NULL;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  g_pending_tcp_connections = NULL;
+#endif
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -842,15 +1193,30 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_remactive(conn);
     }
 
+  /* Remove the connection from the local port hash table and from the list
+   * of connections to be polled.
+   */
+
+  tcp_remport(conn);
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  tcp_rempending(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
   iob_free_queue(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* Release any out-of-order segments retained by the connection */
+
+  tcp_ooseq_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -948,6 +1314,78 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_callback_pend
+ *
+ * Description:
+ *   Add the connection to the list of connections that are visited when
+ *   the network device is polled.  This is called each time that a data
+ *   callback is allocated for the connection.
+ *
+ * Returned Value:
+ *   The callback structure 'cb' is returned.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+FAR struct devif_callback_s *
+  tcp_callback_pend(FAR struct tcp_conn_s *conn,
+                    FAR struct devif_callback_s *cb)
+{
+  if (cb != NULL && !conn->pending)
+    {
+      conn->pblink = NULL;
+      conn->pflink = g_pending_tcp_connections;
+      if (conn->pflink != NULL)
+        {
+          conn->pflink->pblink = conn;
+        }
+
+      g_pending_tcp_connections = conn;
+      conn->pending = 1;
+    }
+
+  return cb;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_nextpending
+ *
+ * Description:
+ *   Traverse the list of TCP connections that may have data to send when
+ *   polled.  As the traversal moves past a connection, that connection is
+ *   removed from the list if it no longer has any callback that responds to
+ *   TCP_POLL.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+FAR struct tcp_conn_s *tcp_nextpending(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *next;
+
+  if (conn == NULL)
+    {
+      return g_pending_tcp_connections;
+    }
+
+  next = conn->pflink;
+  if (!tcp_pollwanted(conn))
+    {
+      tcp_rempending(conn);
+    }
+
+  return next;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -1110,7 +1548,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_addport(conn);
+      tcp_addactive(conn);
     }
 
   return conn;
@@ -1341,6 +1780,8 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
+
+  tcp_remport(conn);
   conn->lport      = htons((uint16_t)port);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
@@ -1364,7 +1805,8 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_addport(conn);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
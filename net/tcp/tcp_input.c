@@ -64,6 +64,116 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_option
+ *
+ * Description:
+ *   Parse the TCP options carried by a SYN or SYNACK segment:  The MSS
+ *   option and, if enabled, the window scale and SACK permitted options.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received TCP packet.
+ *   conn  - The TCP connection structure
+ *   tcp   - A pointer to the TCP header in the packet
+ *   iplen - The length of the IP header
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+static void tcp_parse_option(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_hdr_s *tcp, unsigned int iplen)
+{
+  FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  unsigned int i;
+  uint16_t tmp16;
+  uint8_t opt;
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_SACK)
+  /* Nothing is negotiated unless the peer's SYN says so */
+
+  conn->tcpopts = 0;
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->sndscale = 0;
+  conn->rcvscale = 0;
+#endif
+
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      return;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      opt = optdata[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= optlen || optdata[i + 1] < 2 ||
+          i + optdata[i + 1] > optlen)
+        {
+          /* If the length field is bad, the options are malformed and we
+           * don't process them further.
+           */
+
+          break;
+        }
+
+      if (opt == TCP_OPT_MSS && optdata[i + 1] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)optdata[i + 2] << 8) | (uint16_t)optdata[i + 3];
+          conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS && optdata[i + 1] == TCP_OPT_WS_LEN)
+        {
+          /* The peer's windows will be scaled by this shift, which may
+           * not exceed 14 (RFC 7323, section 2.3).  Receipt of the
+           * option also means that our windows may be scaled.
+           */
+
+          conn->sndscale = optdata[i + 2] > TCP_MAX_WSCALE ?
+                           TCP_MAX_WSCALE : optdata[i + 2];
+          conn->rcvscale = tcp_wscale(dev);
+          conn->tcpopts |= TCP_OPTF_WSCALE;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      else if (opt == TCP_OPT_SACK_PERM &&
+               optdata[i + 1] == TCP_OPT_SACK_PERM_LEN)
+        {
+          conn->tcpopts |= TCP_OPTF_SACK;
+        }
+#endif
+
+      i += optdata[i + 1];
+    }
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -88,13 +198,13 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
+#ifdef CONFIG_NET_TCP_CC
+  uint32_t prevwnd;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -112,10 +222,6 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
   if (tcp_chksum(dev) != 0xffff)
@@ -212,58 +318,9 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP options (MSS, etc.), if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_option(dev, conn, tcp, iplen);
 
           /* Our response will be a SYNACK. */
 
@@ -293,10 +350,27 @@ reset:
 
 found:
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Remember the old window so that window updates can be told apart from
+   * duplicate ACKs.
+   */
+
+  prevwnd = conn->winsize;
+#endif
+
   /* Update the connection's window size */
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN segment is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->sndscale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -342,6 +416,24 @@ found:
       if ((dev->d_len > 0 || ((tcp->flags & (TCP_SYN | TCP_FIN)) != 0)) &&
           memcmp(tcp->seqno, conn->rcvseq, 4) != 0)
         {
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+          /* If this is plain data received beyond a missing segment,
+           * retain it so that only the missing segment need be
+           * retransmitted.  The duplicate ACK below tells the peer where
+           * the gap begins.
+           */
+
+          if (dev->d_len > 0 &&
+              (tcp->flags & (TCP_SYN | TCP_FIN | TCP_URG)) == 0 &&
+              (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+              (conn->tcpstateflags & TCP_STOPPED) == 0)
+            {
+              tcp_ooseq_add(dev, conn, tcp_getsequence(tcp->seqno),
+                            &dev->d_buf[NET_LL_HDRLEN(dev) + iplen + len],
+                            dev->d_len);
+            }
+#endif
+
           tcp_send(dev, conn, TCP_ACK, tcpiplen);
           return;
         }
@@ -434,6 +526,18 @@ found:
           conn->rto = (conn->sa >> 3) + conn->sv;
         }
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Update the congestion window.  A fast retransmission is requested
+       * by adding TCP_REXMIT to the TCP_ACKDATA event below.
+       */
+
+      if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+          tcp_cc_ack(conn, ackseq, dev->d_len, conn->winsize != prevwnd))
+        {
+          flags |= TCP_REXMIT;
+        }
+#endif
+
         /* Set the acknowledged flag. */
 
        flags |= TCP_ACKDATA;
@@ -471,6 +575,9 @@ found:
             conn->sndseq_max    = 0;
 #endif
             conn->unacked       = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
             flags               = TCP_CONNECTED;
             ninfo("TCP state: TCP_ESTABLISHED\n");
 
@@ -505,59 +612,9 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP options (MSS, etc.), if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_parse_option(dev, conn, tcp, iplen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -568,6 +625,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -731,6 +791,19 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+                /* The new data may have filled the gap in front of
+                 * retained out-of-order data.  If so, that data follows
+                 * the new data into the read-ahead buffers and will be
+                 * covered by the ACK.
+                 */
+
+                if (conn->nooseq > 0)
+                  {
+                    tcp_ooseq_deliver(conn);
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
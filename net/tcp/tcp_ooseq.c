@@ -0,0 +1,402 @@
+/****************************************************************************
+ * net/tcp/tcp_ooseq.c
+ * Retention of TCP segments received out of order
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_OUT_OF_ORDER)
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+
+#include "iob/iob.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of bytes held by an out-of-order segment */
+
+#define OOSEQ_LEN(seg)  ((seg)->iob->io_pktlen)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_ooseq_remove
+ *
+ * Description:
+ *   Remove the entry at 'ndx' from the out-of-order queue, returning its
+ *   I/O buffer chain.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *tcp_ooseq_remove(FAR struct tcp_conn_s *conn,
+                                          int ndx)
+{
+  FAR struct iob_s *iob = conn->ooseq[ndx].iob;
+
+  conn->nooseq--;
+  memmove(&conn->ooseq[ndx], &conn->ooseq[ndx + 1],
+          (conn->nooseq - ndx) * sizeof(struct tcp_ooseq_s));
+
+  return iob;
+}
+
+/****************************************************************************
+ * Function: tcp_ooseq_chainlen
+ *
+ * Description:
+ *   Return the number of I/O buffers in an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_ooseq_chainlen(FAR struct iob_s *iob)
+{
+  unsigned int count = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      count++;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_ooseq_add
+ *
+ * Description:
+ *   Retain the data from a segment that was received beyond a gap in the
+ *   sequence space.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the segment
+ *   conn   - The TCP connection structure
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - A pointer to the segment data
+ *   buflen - The number of bytes of segment data
+ *
+ * Returned value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ooseq_add(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                   uint32_t seqno, FAR const uint8_t *buffer,
+                   uint16_t buflen)
+{
+  FAR struct tcp_ooseq_s *seg;
+  FAR struct iob_s *iob;
+  uint32_t rcvseq;
+  uint32_t offset;
+  uint32_t wndo;
+#if CONFIG_NET_TCP_READAHEAD_QUOTA > 0
+  unsigned int held;
+  unsigned int needed;
+#endif
+  int ndx;
+  int ret;
+
+  /* Ignore data that precedes rcvseq (a retransmission of data that we
+   * have already received) or that lies beyond the advertised window.
+   * Entries are ordered by their offset from rcvseq; all offsets are
+   * within the window so simple unsigned comparisons suffice.
+   */
+
+  rcvseq = tcp_getsequence(conn->rcvseq);
+  offset = seqno - rcvseq;
+  wndo   = NET_DEV_RCVWNDO(dev);
+
+  if ((int32_t)offset <= 0 || offset >= wndo)
+    {
+      return;
+    }
+
+  if (offset + buflen > wndo)
+    {
+      buflen = wndo - offset;
+    }
+
+  /* Find where the segment goes.  Ignore it if its data is already
+   * held.
+   */
+
+  for (ndx = 0; ndx < conn->nooseq; ndx++)
+    {
+      uint32_t segoffset;
+
+      seg       = &conn->ooseq[ndx];
+      segoffset = seg->seqno - rcvseq;
+
+      if (segoffset <= offset &&
+          segoffset + OOSEQ_LEN(seg) >= offset + buflen)
+        {
+          return;
+        }
+
+      if (segoffset > offset)
+        {
+          break;
+        }
+    }
+
+  /* Make room if the queue is full.  The data closest to rcvseq is the
+   * most valuable so, if the new segment lies beyond all retained
+   * segments, it is the one that is discarded.
+   */
+
+  if (conn->nooseq >= CONFIG_NET_TCP_OOSEQ_NSEGS)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.oodrop++;
+#endif
+
+      if (ndx >= conn->nooseq)
+        {
+          ninfo("Queue full, dropped seqno=%08lx\n", (unsigned long)seqno);
+          return;
+        }
+
+      iob_free_chain(tcp_ooseq_remove(conn, conn->nooseq - 1));
+    }
+
+#if CONFIG_NET_TCP_READAHEAD_QUOTA > 0
+  /* The retained data will end up in the read-ahead buffers, so it counts
+   * against the read-ahead quota.  As above, retained segments beyond the
+   * new one are discarded to make room for it.
+   */
+
+  held   = iob_count_queue(&conn->readahead) + tcp_ooseq_count(conn);
+  needed = (buflen + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE;
+
+  while (held + needed > CONFIG_NET_TCP_READAHEAD_QUOTA &&
+         ndx < conn->nooseq)
+    {
+      iob = tcp_ooseq_remove(conn, conn->nooseq - 1);
+      held -= tcp_ooseq_chainlen(iob);
+      iob_free_chain(iob);
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.oodrop++;
+#endif
+    }
+
+  if (held + needed > CONFIG_NET_TCP_READAHEAD_QUOTA)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.oodrop++;
+#endif
+
+      ninfo("Quota reached, dropped seqno=%08lx\n", (unsigned long)seqno);
+      return;
+    }
+#endif
+
+  /* Copy the data into a new I/O buffer chain without waiting and with
+   * throttling.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      goto errout;
+    }
+
+  ret = iob_trycopyin(iob, buffer, buflen, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      goto errout;
+    }
+
+  /* Insert the new entry at ndx */
+
+  memmove(&conn->ooseq[ndx + 1], &conn->ooseq[ndx],
+          (conn->nooseq - ndx) * sizeof(struct tcp_ooseq_s));
+
+  seg        = &conn->ooseq[ndx];
+  seg->seqno = seqno;
+  seg->iob   = iob;
+  conn->nooseq++;
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.ooseq++;
+#endif
+
+  ninfo("Retained seqno=%08lx len=%u at %d/%d\n",
+        (unsigned long)seqno, buflen, ndx, conn->nooseq);
+  return;
+
+errout:
+  nwarn("WARNING: No I/O buffers, dropped seqno=%08lx\n",
+        (unsigned long)seqno);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.oodrop++;
+#endif
+}
+
+/****************************************************************************
+ * Function: tcp_ooseq_deliver
+ *
+ * Description:
+ *   Move any retained out-of-order data that is now contiguous with
+ *   conn->rcvseq to the read-ahead buffers and advance conn->rcvseq past
+ *   it.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ooseq_deliver(FAR struct tcp_conn_s *conn)
+{
+  FAR struct iob_s *iob;
+  uint32_t rcvseq;
+  uint32_t overlap;
+  uint32_t pktlen;
+
+  rcvseq = tcp_getsequence(conn->rcvseq);
+
+  while (conn->nooseq > 0)
+    {
+      /* Stop at the first gap */
+
+      overlap = rcvseq - conn->ooseq[0].seqno;
+      if ((int32_t)overlap < 0)
+        {
+          break;
+        }
+
+      iob    = tcp_ooseq_remove(conn, 0);
+      pktlen = iob->io_pktlen;
+
+      /* Discard any data that has already been received */
+
+      if (overlap >= pktlen)
+        {
+          iob_free_chain(iob);
+          continue;
+        }
+
+      if (overlap > 0)
+        {
+          iob = iob_trimhead(iob, overlap);
+        }
+
+      /* Add the remainder to the tail of the read-ahead queue.  If that
+       * fails, the data is lost and the peer will have to retransmit it.
+       */
+
+      if (iob_tryadd_queue(iob, &conn->readahead) < 0)
+        {
+          nwarn("WARNING: Failed to queue out-of-order data\n");
+          iob_free_chain(iob);
+          break;
+        }
+
+      ninfo("Delivered seqno=%08lx len=%lu\n",
+            (unsigned long)rcvseq, (unsigned long)(pktlen - overlap));
+
+      rcvseq += pktlen - overlap;
+    }
+
+  tcp_setsequence(conn->rcvseq, rcvseq);
+}
+
+/****************************************************************************
+ * Function: tcp_ooseq_free
+ *
+ * Description:
+ *   Release all retained out-of-order data.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ooseq_free(FAR struct tcp_conn_s *conn)
+{
+  while (conn->nooseq > 0)
+    {
+      iob_free_chain(tcp_ooseq_remove(conn, conn->nooseq - 1));
+    }
+}
+
+/****************************************************************************
+ * Function: tcp_ooseq_count
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the retained out-of-order
+ *   data.  These count against the read-ahead quota of the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+unsigned int tcp_ooseq_count(FAR struct tcp_conn_s *conn)
+{
+  unsigned int count = 0;
+  int ndx;
+
+  for (ndx = 0; ndx < conn->nooseq; ndx++)
+    {
+      count += tcp_ooseq_chainlen(conn->ooseq[ndx].iob);
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_OUT_OF_ORDER */
@@ -0,0 +1,228 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ * TCP selective acknowledgement (RFC 2018)
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SACK)
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_sack_build
+ *
+ * Description:
+ *   Format a SACK option describing the out-of-order data retained by the
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure
+ *   opt  - The location in the TCP header at which to build the option
+ *
+ * Returned value:
+ *   The number of bytes of option data, a multiple of four.  Zero is
+ *   returned if no out-of-order data is retained.
+ *
+ ****************************************************************************/
+
+unsigned int tcp_sack_build(FAR struct tcp_conn_s *conn, FAR uint8_t *opt)
+{
+  FAR struct tcp_ooseq_s *seg;
+  uint32_t left;
+  uint32_t right;
+  int nblocks;
+  int ndx;
+
+  if (conn->nooseq == 0)
+    {
+      return 0;
+    }
+
+  /* The option is preceded by two NOPs to keep the blocks aligned */
+
+  opt[0]  = TCP_OPT_NOOP;
+  opt[1]  = TCP_OPT_NOOP;
+  opt[2]  = TCP_OPT_SACK;
+  nblocks = 0;
+
+  /* The out-of-order segments are sorted by sequence number.  Merge
+   * adjacent and overlapping segments into blocks.  RFC 2018 prefers that
+   * the most recently received block come first, but any valid set of
+   * blocks is acceptable.
+   */
+
+  seg   = &conn->ooseq[0];
+  left  = seg->seqno;
+  right = seg->seqno + seg->iob->io_pktlen;
+
+  for (ndx = 1; ndx <= conn->nooseq && nblocks < TCP_MAX_SACKBLKS; ndx++)
+    {
+      FAR uint8_t *blk;
+
+      if (ndx < conn->nooseq)
+        {
+          seg = &conn->ooseq[ndx];
+          if ((int32_t)(seg->seqno - right) <= 0)
+            {
+              uint32_t end = seg->seqno + seg->iob->io_pktlen;
+
+              if ((int32_t)(end - right) > 0)
+                {
+                  right = end;
+                }
+
+              continue;
+            }
+        }
+
+      /* Emit the block [left, right) */
+
+      blk    = &opt[4 + nblocks * TCP_OPT_SACK_BLKLEN];
+      blk[0] = left >> 24;
+      blk[1] = left >> 16;
+      blk[2] = left >> 8;
+      blk[3] = left;
+      blk[4] = right >> 24;
+      blk[5] = right >> 16;
+      blk[6] = right >> 8;
+      blk[7] = right;
+      nblocks++;
+
+      if (ndx < conn->nooseq)
+        {
+          left  = seg->seqno;
+          right = seg->seqno + seg->iob->io_pktlen;
+        }
+    }
+
+  opt[3] = 2 + nblocks * TCP_OPT_SACK_BLKLEN;
+  return 4 + nblocks * TCP_OPT_SACK_BLKLEN;
+}
+
+/****************************************************************************
+ * Function: tcp_sack_parse
+ *
+ * Description:
+ *   Extract the blocks of the SACK option, if any, from a received TCP
+ *   header.
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   blocks - The location to return the SACK blocks
+ *
+ * Returned value:
+ *   The number of SACK blocks returned, up to TCP_MAX_SACKBLKS.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+int tcp_sack_parse(FAR struct tcp_hdr_s *tcp,
+                   FAR struct tcp_sackblk_s *blocks)
+{
+  FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  unsigned int i;
+  int nblocks;
+  int ndx;
+
+  for (i = 0; i < optlen; )
+    {
+      uint8_t opt = optdata[i];
+
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      if (i + 1 >= optlen || optdata[i + 1] < 2 ||
+          i + optdata[i + 1] > optlen)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      if (opt == TCP_OPT_SACK)
+        {
+          FAR const uint8_t *blk = &optdata[i + 2];
+
+          nblocks = (optdata[i + 1] - 2) / TCP_OPT_SACK_BLKLEN;
+          if (nblocks > TCP_MAX_SACKBLKS)
+            {
+              nblocks = TCP_MAX_SACKBLKS;
+            }
+
+          for (ndx = 0; ndx < nblocks; ndx++, blk += TCP_OPT_SACK_BLKLEN)
+            {
+              blocks[ndx].left  = ((uint32_t)blk[0] << 24) |
+                                ((uint32_t)blk[1] << 16) |
+                                ((uint32_t)blk[2] << 8)  |
+                                 (uint32_t)blk[3];
+              blocks[ndx].right = ((uint32_t)blk[4] << 24) |
+                                ((uint32_t)blk[5] << 16) |
+                                ((uint32_t)blk[6] << 8)  |
+                                 (uint32_t)blk[7];
+            }
+
+          return nblocks;
+        }
+
+      i += optdata[i + 1];
+    }
+
+  return 0;
+}
+#endif /* CONFIG_NET_TCP_CC */
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SACK */
@@ -353,8 +353,27 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      uint32_t wnd = NET_DEV_RCVWNDO(dev);
+
+      /* The window field of a SYN segment is never scaled */
+
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          wnd >>= conn->rcvscale;
+        }
+
+      if (wnd > UINT16_MAX)
+        {
+          wnd = UINT16_MAX;
+        }
+
+      tcp->wnd[0] = wnd >> 8;
+      tcp->wnd[1] = wnd & 0xff;
+#else
       tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
       tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+#endif
     }
 
   /* Finish the IP portion of the message and calculate checksums */
@@ -395,9 +414,58 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags     = flags;
   dev->d_len     = len;
   tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* If this is a pure ACK (no data) and out-of-order data is being
+   * retained, then tell the peer what we have with a SACK option.
+   */
+
+  if (flags == TCP_ACK && conn->nooseq > 0 &&
+      (conn->tcpopts & TCP_OPTF_SACK) != 0 &&
+      len == (FAR uint8_t *)tcp - &dev->d_buf[NET_LL_HDRLEN(dev)] +
+             TCP_HDRLEN)
+    {
+      unsigned int optlen;
+
+      optlen          = tcp_sack_build(conn, (FAR uint8_t *)tcp + TCP_HDRLEN);
+      dev->d_len     += optlen;
+      tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
+    }
+#endif
+
   tcp_sendcommon(dev, conn, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_wscale
+ *
+ * Description:
+ *   Return the window scale shift that we offer to the peer:  The smallest
+ *   shift that allows the device's receive window to be advertised.
+ *
+ * Parameters:
+ *   dev - The device driver structure to use in the send operation
+ *
+ * Return:
+ *   The window scale shift, 0 through TCP_MAX_WSCALE.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_wscale(FAR struct net_driver_s *dev)
+{
+  uint32_t wnd = NET_DEV_RCVWNDO(dev);
+  uint8_t shift = 0;
+
+  while ((wnd >> shift) > UINT16_MAX && shift < TCP_MAX_WSCALE)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_reset
  *
@@ -536,7 +604,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack)
 {
   struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
   uint16_t tcp_mss;
+  uint16_t optlen;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -550,9 +620,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv6BUF;
       tcp_mss = TCP_IPv6_MSS(dev);
 
-      /* Set the the packet length for the TCP Maximum Segment Size */
+      /* Set the the packet length for the TCP header */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -566,9 +636,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv4BUF;
       tcp_mss = TCP_IPv4_MSS(dev);
 
-      /* Set the the packet length for the TCP Maximum Segment Size */
+      /* Set the the packet length for the TCP header */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -578,11 +648,41 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   /* We send out the TCP Maximum Segment Size option with our ack. */
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optdata         = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optdata[0]      = TCP_OPT_MSS;
+  optdata[1]      = TCP_OPT_MSS_LEN;
+  optdata[2]      = tcp_mss >> 8;
+  optdata[3]      = tcp_mss & 0xff;
+  optlen          = TCP_OPT_MSS_LEN;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling in a SYN.  Accept it in a SYNACK only if the
+   * peer offered it.
+   */
+
+  if (ack == TCP_SYN || (conn->tcpopts & TCP_OPTF_WSCALE) != 0)
+    {
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_WS;
+      optdata[optlen++] = TCP_OPT_WS_LEN;
+      optdata[optlen++] = tcp_wscale(dev);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Likewise for SACK */
+
+  if (ack == TCP_SYN || (conn->tcpopts & TCP_OPTF_SACK) != 0)
+    {
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_NOOP;
+      optdata[optlen++] = TCP_OPT_SACK_PERM;
+      optdata[optlen++] = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+  dev->d_len     += optlen;
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
@@ -205,6 +205,65 @@ static inline void psock_lost_connection(FAR struct socket *psock,
   conn->sndseq_max = 0;
 }
 
+/****************************************************************************
+ * Function: psock_sack_mark
+ *
+ * Description:
+ *   Mark each write buffer in the unacked_q that is entirely covered by a
+ *   SACK block of the received TCP header.  Marked write buffers are not
+ *   retransmitted on a fast retransmission.
+ *
+ * Parameters:
+ *   conn  The connection structure associated with the socket
+ *   tcp   The TCP header of the received segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+static void psock_sack_mark(FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_hdr_s *tcp)
+{
+  struct tcp_sackblk_s blocks[TCP_MAX_SACKBLKS];
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  int nblocks;
+  int i;
+
+  nblocks = tcp_sack_parse(tcp, blocks);
+  if (nblocks <= 0)
+    {
+      return;
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      uint32_t lastseq;
+
+      wrb     = (FAR struct tcp_wrbuffer_s *)entry;
+      lastseq = WRB_SEQNO(wrb) + WRB_PKTLEN(wrb);
+
+      for (i = 0; i < nblocks; i++)
+        {
+          if ((int32_t)(WRB_SEQNO(wrb) - blocks[i].left) >= 0 &&
+              (int32_t)(blocks[i].right - lastseq) >= 0)
+            {
+              ninfo("SACK: wrb=%p seqno=%u pktlen=%u\n",
+                    wrb, WRB_SEQNO(wrb), WRB_PKTLEN(wrb));
+
+              WRB_SACKED(wrb) = 1;
+              break;
+            }
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Function: send_ipselect
  *
@@ -430,6 +489,7 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
 
                   /* And return the write buffer to the pool of free buffers */
 
+                  WRB_SETACKED(wrb);
                   tcp_wrbuffer_release(wrb);
                 }
               else
@@ -464,6 +524,15 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
             }
         }
 
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+      /* Note any un-ACKed write buffers that the peer already holds */
+
+      if ((conn->tcpopts & TCP_OPTF_SACK) != 0)
+        {
+          psock_sack_mark(conn, tcp);
+        }
+
+#endif
       /* A special case is the head of the write_q which may be partially
        * sent and so can still have un-ACKed bytes that could get ACKed
        * before the entire write buffer has even been sent.
@@ -517,12 +586,18 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
       return flags;
     }
 
-   /* Check if we are being asked to retransmit data */
+  /* Check if we are being asked to retransmit data.  With congestion
+   * control, this may accompany TCP_ACKDATA when duplicate ACKs call for a
+   * fast retransmission.
+   */
 
-   else if ((flags & TCP_REXMIT) != 0)
+  if ((flags & TCP_REXMIT) != 0)
     {
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+      sq_queue_t sacked;
+#endif
 
       ninfo("REXMIT: %04x\n", flags);
 
@@ -599,11 +674,31 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
        * write_q so they can be resent as soon as possible.
        */
 
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+      sq_init(&sacked);
+#endif
+
       while ((entry = sq_remlast(&conn->unacked_q)) != NULL)
         {
           wrb = (FAR struct tcp_wrbuffer_s *)entry;
           uint16_t sent;
 
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+          /* On a fast retransmission, leave the segments that the peer
+           * has selectively acknowledged in the unacked_q.  After a
+           * timeout, the peer may have discarded them (RFC 2018, section
+           * 8) so everything is retransmitted.
+           */
+
+          if ((flags & TCP_ACKDATA) != 0 && WRB_SACKED(wrb))
+            {
+              sq_addfirst(entry, &sacked);
+              continue;
+            }
+
+          WRB_SACKED(wrb) = 0;
+
+#endif
           /* Reset the number of bytes sent sent from the write buffer */
 
           sent = WRB_SENT(wrb);
@@ -664,6 +759,10 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
               psock_insert_segment(wrb, &conn->write_q);
             }
         }
+
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_CC)
+      conn->unacked_q = sacked;
+#endif
     }
 
   /* Check if the outgoing packet is available (it may have been claimed
@@ -698,6 +797,9 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
         {
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
+#ifdef CONFIG_NET_TCP_CC
+          uint32_t wndlen;
+#endif
           size_t sndlen;
 
           /* Peek at the head of the write queue (but don't remove anything
@@ -720,10 +822,33 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
               sndlen = conn->mss;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* Limit the data in flight to the smaller of the congestion
+           * window and the peer's receive window.  Don't send a runt
+           * segment if a full one will be permitted once more of the
+           * outstanding data has been ACKed.
+           */
+
+          wndlen = tcp_cc_window(conn);
+          wndlen = wndlen > conn->unacked ? wndlen - conn->unacked : 0;
+
+          if (sndlen > wndlen)
+            {
+              if (wndlen == 0 || (wndlen < conn->mss && conn->unacked > 0))
+                {
+                  ninfo("SEND: wrb=%p cwnd=%lu unacked=%u, waiting\n",
+                        wrb, (unsigned long)conn->cwnd, conn->unacked);
+                  return flags;
+                }
+
+              sndlen = wndlen;
+            }
+#else
           if (sndlen > conn->winsize)
             {
               sndlen = conn->winsize;
             }
+#endif
 
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, WRB_PKTLEN(wrb), WRB_SENT(wrb), sndlen);
@@ -761,7 +886,16 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
            * won't actually happen until the polling cycle completes).
            */
 
-          devif_iob_send(dev, WRB_IOB(wrb), sndlen, WRB_SENT(wrb));
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+          if (WRB_ISZEROCOPY(wrb))
+            {
+              devif_send(dev, WRB_BUFFER(wrb) + WRB_SENT(wrb), sndlen);
+            }
+          else
+#endif
+            {
+              devif_iob_send(dev, WRB_IOB(wrb), sndlen, WRB_SENT(wrb));
+            }
 
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
@@ -883,68 +1017,17 @@ static inline void send_txnotify(FAR struct socket *psock,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Function: psock_tcp_send
+ * Function: psock_tcp_queue
  *
  * Description:
- *   psock_tcp_send() call may be used only when the TCP socket is in a
- *   connected state (so that the intended recipient is known).
- *
- * Parameters:
- *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *
- * Returned Value:
- *   On success, returns the number of characters sent.  On  error,
- *   -1 is returned, and errno is set appropriately:
- *
- *   EAGAIN or EWOULDBLOCK
- *     The socket is marked non-blocking and the requested operation
- *     would block.
- *   EBADF
- *     An invalid descriptor was specified.
- *   ECONNRESET
- *     Connection reset by peer.
- *   EDESTADDRREQ
- *     The socket is not connection-mode, and no peer address is set.
- *   EFAULT
- *      An invalid user space address was specified for a parameter.
- *   EINTR
- *      A signal occurred before any data was transmitted.
- *   EINVAL
- *      Invalid argument passed.
- *   EISCONN
- *     The connection-mode socket was connected already but a recipient
- *     was specified. (Now either this error is returned, or the recipient
- *     specification is ignored.)
- *   EMSGSIZE
- *     The socket type requires that message be sent atomically, and the
- *     size of the message to be sent made this impossible.
- *   ENOBUFS
- *     The output queue for a network interface was full. This generally
- *     indicates that the interface has stopped sending, but may be
- *     caused by transient congestion.
- *   ENOMEM
- *     No memory available.
- *   ENOTCONN
- *     The socket is not connected, and no target has been given.
- *   ENOTSOCK
- *     The argument s is not a socket.
- *   EPIPE
- *     The local end has been shut down on a connection oriented socket.
- *     In this case the process will also receive a SIGPIPE unless
- *     MSG_NOSIGNAL is set.
- *
- * Assumptions:
+ *   Queue data for transfer on a connected TCP socket:  Either a copy of
+ *   the data or, if notify is not NULL, a reference to the caller's data.
  *
  ****************************************************************************/
 
-ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+static ssize_t psock_tcp_queue(FAR struct socket *psock, FAR const void *buf,
+                               size_t len, send_zcnotify_t notify,
+                               FAR void *arg)
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
@@ -1019,7 +1102,17 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        */
 
       net_lock();
-      wrb = tcp_wrbuffer_alloc();
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+      if (notify != NULL)
+        {
+          wrb = tcp_wrbuffer_zcalloc();
+        }
+      else
+#endif
+        {
+          wrb = tcp_wrbuffer_alloc();
+        }
+
       if (!wrb)
         {
           /* A buffer allocation error occurred */
@@ -1058,11 +1151,34 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
       WRB_SEQNO(wrb) = (unsigned)-1;
       WRB_NRTX(wrb)  = 0;
-      result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
 
-      /* Dump I/O buffer chain */
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+      if (notify != NULL)
+        {
+          /* Refer to the caller's data.  The length of a write buffer is
+           * limited to 16-bits.
+           */
+
+          if (len > UINT16_MAX)
+            {
+              len = UINT16_MAX;
+            }
+
+          wrb->wb_buffer = (FAR const uint8_t *)buf;
+          wrb->wb_buflen = len;
+          wrb->wb_notify = notify;
+          wrb->wb_arg    = arg;
+          result         = len;
+        }
+      else
+#endif
+        {
+          result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
 
-      WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
+          /* Dump I/O buffer chain */
+
+          WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
+        }
 
       /* psock_send_interrupt() will send data in FIFO order from the
        * conn->write_q
@@ -1108,6 +1224,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   return result;
 
 errout_with_wrb:
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+  wrb->wb_notify = NULL;
+#endif
   tcp_wrbuffer_release(wrb);
 
 errout_with_lock:
@@ -1118,6 +1237,115 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_tcp_send
+ *
+ * Description:
+ *   psock_tcp_send() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   -1 is returned, and errno is set appropriately:
+ *
+ *   EAGAIN or EWOULDBLOCK
+ *     The socket is marked non-blocking and the requested operation
+ *     would block.
+ *   EBADF
+ *     An invalid descriptor was specified.
+ *   ECONNRESET
+ *     Connection reset by peer.
+ *   EDESTADDRREQ
+ *     The socket is not connection-mode, and no peer address is set.
+ *   EFAULT
+ *      An invalid user space address was specified for a parameter.
+ *   EINTR
+ *      A signal occurred before any data was transmitted.
+ *   EINVAL
+ *      Invalid argument passed.
+ *   EISCONN
+ *     The connection-mode socket was connected already but a recipient
+ *     was specified. (Now either this error is returned, or the recipient
+ *     specification is ignored.)
+ *   EMSGSIZE
+ *     The socket type requires that message be sent atomically, and the
+ *     size of the message to be sent made this impossible.
+ *   ENOBUFS
+ *     The output queue for a network interface was full. This generally
+ *     indicates that the interface has stopped sending, but may be
+ *     caused by transient congestion.
+ *   ENOMEM
+ *     No memory available.
+ *   ENOTCONN
+ *     The socket is not connected, and no target has been given.
+ *   ENOTSOCK
+ *     The argument s is not a socket.
+ *   EPIPE
+ *     The local end has been shut down on a connection oriented socket.
+ *     In this case the process will also receive a SIGPIPE unless
+ *     MSG_NOSIGNAL is set.
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  return psock_tcp_queue(psock, buf, len, NULL, NULL);
+}
+
+/****************************************************************************
+ * Function: psock_tcp_send_zerocopy
+ *
+ * Description:
+ *   Like psock_tcp_send() except that the data is not copied:  The write
+ *   buffer refers to the caller's data, which must not be modified or
+ *   freed until notify is called.  notify is called with OK when all of
+ *   the data has been ACKed, or with a negated errno value if the data
+ *   was discarded because the connection was lost.  It is called from the
+ *   network stack with the network locked and must not block.
+ *
+ *   No more than UINT16_MAX bytes are queued by one call.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   notify   Called when the data is no longer referenced
+ *   arg      Argument passed to notify
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  notify will be called
+ *   exactly once for those bytes.  On error, -1 is returned, errno is set
+ *   as for psock_tcp_send(), and notify will not be called.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+ssize_t psock_tcp_send_zerocopy(FAR struct socket *psock,
+                                FAR const void *buf, size_t len,
+                                send_zcnotify_t notify, FAR void *arg)
+{
+  if (notify == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return psock_tcp_queue(psock, buf, len, notify, arg);
+}
+#endif
+
 /****************************************************************************
  * Function: psock_tcp_cansend
  *
@@ -284,6 +284,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                      * the code for sending out the packet.
                      */
 
+#ifdef CONFIG_NET_TCP_CC
+                    tcp_cc_timeout(conn);
+#endif
                     result = tcp_callback(dev, conn, TCP_REXMIT);
                     tcp_rexmit(dev, conn, result);
                     goto done;
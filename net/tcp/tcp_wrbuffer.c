@@ -51,6 +51,7 @@
 #include <queue.h>
 #include <semaphore.h>
 #include <string.h>
+#include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -117,6 +118,32 @@ void tcp_wrbuffer_initialize(void)
   sem_init(&g_wrbuffer.sem, 0, CONFIG_NET_TCP_NWRBCHAINS);
 }
 
+/****************************************************************************
+ * Function: tcp_wrbuffer_take
+ *
+ * Description:
+ *   Take a pre-allocated write buffer structure from the free list, waiting
+ *   if necessary.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_wrbuffer_s *tcp_wrbuffer_take(void)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  DEBUGVERIFY(net_lockedwait(&g_wrbuffer.sem));
+
+  /* Now, we are guaranteed to have a write buffer structure reserved
+   * for us in the free list.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  DEBUGASSERT(wrb);
+  memset(wrb, 0, sizeof(struct tcp_wrbuffer_s));
+
+  return wrb;
+}
+
 /****************************************************************************
  * Function: tcp_wrbuffer_alloc
  *
@@ -145,15 +172,7 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
    * buffer
    */
 
-  DEBUGVERIFY(net_lockedwait(&g_wrbuffer.sem));
-
-  /* Now, we are guaranteed to have a write buffer structure reserved
-   * for us in the free list.
-   */
-
-  wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
-  DEBUGASSERT(wrb);
-  memset(wrb, 0, sizeof(struct tcp_wrbuffer_s));
+  wrb = tcp_wrbuffer_take();
 
   /* Now get the first I/O buffer for the write buffer structure */
 
@@ -168,6 +187,25 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
   return wrb;
 }
 
+/****************************************************************************
+ * Function: tcp_wrbuffer_zcalloc
+ *
+ * Description:
+ *   Allocate a TCP write buffer that will refer to the caller's data rather
+ *   than holding a copy of it in an I/O buffer chain.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_zcalloc(void)
+{
+  return tcp_wrbuffer_take();
+}
+#endif
+
 /****************************************************************************
  * Function: tcp_wrbuffer_release
  *
@@ -183,13 +221,27 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
 
 void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
 {
-  DEBUGASSERT(wrb && wrb->wb_iob);
+  DEBUGASSERT(wrb);
 
   /* To avoid deadlocks, we must following this ordering:  Release the I/O
    * buffer chain first, then the write buffer structure.
    */
 
-  iob_free_chain(wrb->wb_iob);
+  if (wrb->wb_iob != NULL)
+    {
+      iob_free_chain(wrb->wb_iob);
+    }
+
+#ifdef CONFIG_NET_TCP_SEND_ZEROCOPY
+  /* Or tell the owner of a zero-copy buffer that it is no longer in use.
+   * Any data that remains was not ACKed.
+   */
+
+  else if (wrb->wb_notify != NULL)
+    {
+      wrb->wb_notify(wrb->wb_arg, wrb->wb_buflen == 0 ? OK : -ECONNABORTED);
+    }
+#endif
 
   /* Then free the write buffer structure */
 
@@ -91,6 +91,16 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
+#if CONFIG_NET_UDP_READAHEAD_QUOTA > 0
+  /* Do not let one connection take more than its share of the I/O buffers */
+
+  if (iob_count_queue(&conn->readahead) >= CONFIG_NET_UDP_READAHEAD_QUOTA)
+    {
+      nwarn("WARNING: Read-ahead quota reached\n");
+      return 0;
+    }
+#endif
+
   /* Allocate on I/O buffer to start the chain (throttling as necessary).
    * We will not wait for an I/O buffer to become available in this context.
    */
@@ -64,46 +64,112 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: chksum
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 32-bit one's complement accumulator into 16 bits.
+ *
  ****************************************************************************/
 
 #ifndef CONFIG_NET_ARCH_CHKSUM
-static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+static inline uint16_t chksum_fold(uint32_t acc)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+#endif
 
-  dataptr = data;
-  last_byte = data + len - 1;
+/****************************************************************************
+ * Name: chksum_aligned
+ *
+ * Description:
+ *   Sum a 16-bit aligned buffer.  The data is summed as 16-bit words in
+ *   host byte order into a 32-bit accumulator.  len is at most 65535, so
+ *   the accumulator cannot overflow and no carries need to be handled
+ *   until the end.  Because the one's complement sum is independent of
+ *   byte order (RFC 1071), the folded result need only be byte swapped on
+ *   a little-endian machine.
+ *
+ ****************************************************************************/
 
-  while (dataptr < last_byte)
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t chksum_aligned(FAR const uint8_t *data, uint16_t len)
+{
+  FAR const uint16_t *wptr = (FAR const uint16_t *)data;
+  uint32_t acc = 0;
+  uint16_t sum;
+
+  /* Sum 16 bytes per iteration */
+
+  while (len >= 16)
+    {
+      acc += (uint32_t)wptr[0] + wptr[1] + wptr[2] + wptr[3] +
+             wptr[4] + wptr[5] + wptr[6] + wptr[7];
+      wptr += 8;
+      len  -= 16;
+    }
+
+  while (len >= 2)
     {
-      /* At least two more bytes */
+      acc += *wptr++;
+      len -= 2;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* A trailing odd byte is padded with a zero byte */
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)(*(FAR const uint8_t *)wptr << 8);
+#else
+      acc += *(FAR const uint8_t *)wptr;
+#endif
+    }
+
+  sum = chksum_fold(acc);
+
+#ifdef CONFIG_ENDIAN_BIG
+  return sum;
+#else
+  return (uint16_t)((sum << 8) | (sum >> 8));
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum
+ ****************************************************************************/
 
-      dataptr += 2;
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+
+  if (len == 0)
+    {
+      return sum;
     }
 
-  if (dataptr == last_byte)
+  if (((uintptr_t)data & 1) != 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      /* Odd alignment.  Sum the data from the second byte on, with the
+       * first byte as the low byte of an extra word.  Each byte is then
+       * in the opposite half of a word so the result must be swapped.
+       */
+
+      t = chksum_aligned(data + 1, len - 1);
+      t = chksum_fold((uint32_t)t + data[0]);
+      t = (uint16_t)((t << 8) | (t >> 8));
+    }
+  else
+    {
+      t = chksum_aligned(data, len);
     }
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_fold((uint32_t)sum + t);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
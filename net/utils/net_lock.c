@@ -39,6 +39,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <semaphore.h>
 #include <assert.h>
@@ -47,6 +49,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/net/net.h>
 
 #include "utils/utils.h"
@@ -65,6 +68,15 @@ static sem_t        g_netlock;
 static pid_t        g_holder  = NO_HOLDER;
 static unsigned int g_count   = 0;
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Lock statistics and the time that the current holder took the lock.
+ * Both are modified only by the holder of the lock.
+ */
+
+static struct net_lockstats_s g_lockstats;
+static struct timespec g_holdstart;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -89,6 +101,92 @@ static void _net_takesem(void)
     }
 }
 
+/****************************************************************************
+ * Function: net_holdstart and net_holdend
+ *
+ * Description:
+ *   Mark the beginning and end of an interval during which the calling
+ *   thread holds the lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+static void net_holdstart(bool waited)
+{
+  g_lockstats.nlocks++;
+  if (waited)
+    {
+      g_lockstats.nwaits++;
+    }
+
+  (void)clock_systimespec(&g_holdstart);
+}
+
+static void net_holdend(void)
+{
+  struct timespec now;
+  uint32_t elapsed;
+
+  (void)clock_systimespec(&now);
+  elapsed = (now.tv_sec - g_holdstart.tv_sec) * 1000000 +
+            (now.tv_nsec - g_holdstart.tv_nsec) / 1000;
+
+  g_lockstats.totalhold += elapsed;
+  if (elapsed > g_lockstats.maxhold)
+    {
+      g_lockstats.maxhold   = elapsed;
+      g_lockstats.maxholder = g_holder;
+    }
+}
+#else
+#  define net_holdstart(w)
+#  define net_holdend()
+#endif
+
+/****************************************************************************
+ * Function: net_acquire
+ *
+ * Description:
+ *   Take the semaphore on behalf of the calling thread, noting whether it
+ *   had to wait.
+ *
+ ****************************************************************************/
+
+static void net_acquire(pid_t me, unsigned int count)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  bool waited = false;
+
+  if (sem_trywait(&g_netlock) != 0)
+    {
+      _net_takesem();
+      waited = true;
+    }
+#else
+  _net_takesem();
+#endif
+
+  g_holder = me;
+  g_count  = count;
+  net_holdstart(waited);
+}
+
+/****************************************************************************
+ * Function: net_release
+ *
+ * Description:
+ *   Give up the semaphore held by the calling thread.
+ *
+ ****************************************************************************/
+
+static void net_release(void)
+{
+  net_holdend();
+  g_holder = NO_HOLDER;
+  g_count  = 0;
+  sem_post(&g_netlock);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -128,14 +226,11 @@ void net_lock(void)
     }
   else
     {
-      /* No.. take the semaphore (perhaps waiting) */
-
-      _net_takesem();
-
-      /* Now this thread holds the semaphore */
+      /* No.. take the semaphore (perhaps waiting).  Now this thread holds
+       * the semaphore.
+       */
 
-      g_holder = me;
-      g_count  = 1;
+      net_acquire(me, 1);
     }
 }
 
@@ -157,9 +252,7 @@ void net_unlock(void)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      net_release();
     }
   else
     {
@@ -200,10 +293,8 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
     {
       /* Release the network lock, remembering my count */
 
-      count    = g_count;
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      count = g_count;
+      net_release();
 
       /* Now take the semaphore, waiting if so requested. */
 
@@ -222,9 +313,7 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
-      g_holder = me;
-      g_count  = count;
+      net_acquire(me, count);
     }
   else
     {
@@ -257,3 +346,22 @@ int net_lockedwait(sem_t *sem)
   return net_timedwait(sem, NULL);
 }
 
+/****************************************************************************
+ * Function: net_lockstats
+ *
+ * Description:
+ *   Return a snapshot of the network lock statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats)
+{
+  net_lock();
+  *stats = g_lockstats;
+  net_unlock();
+}
+#endif
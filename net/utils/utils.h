@@ -41,6 +41,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
@@ -57,6 +61,19 @@ enum tv2ds_remainder_e
   TV2DS_CEIL       /* Force to next larger full decisecond */
 };
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Statistics describing the use of the network lock */
+
+struct net_lockstats_s
+{
+  uint32_t nlocks;         /* Number of times the lock was taken */
+  uint32_t nwaits;         /* Number of times that a thread had to wait */
+  uint32_t maxhold;        /* Longest hold time (microseconds) */
+  pid_t    maxholder;      /* The thread that held the lock the longest */
+  uint64_t totalhold;      /* Total hold time (microseconds) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -86,6 +103,21 @@ struct timeval;           /* Forward reference */
 
 void net_lockinitialize(void);
 
+/****************************************************************************
+ * Function: net_lockstats
+ *
+ * Description:
+ *   Return a snapshot of the network lock statistics.
+ *
+ * Input Parameters:
+ *   stats - The location to return the statistics
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats);
+#endif
+
 /****************************************************************************
  * Function: net_dsec2timeval
  *
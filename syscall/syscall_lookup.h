@@ -252,9 +252,8 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(sched_getstreams,        0, STUB_sched_getstreams)
 #  endif
 
-#  if defined(CONFIG_NET_SENDFILE)
-  SYSCALL_LOOKUP(sendfile,                4, STUB_fs_sendifile)
-#  endif
+  SYSCALL_LOOKUP(sendfile,                4, STUB_sendfile)
+  SYSCALL_LOOKUP(readdirstat,             3, STUB_readdirstat)
 
 #  if !defined(CONFIG_DISABLE_MOUNTPOINT)
 #    if defined(CONFIG_FS_READABLE)